@@ -0,0 +1,52 @@
+#ifndef INCLUDE_ACCUMULATOR_HPP
+#define INCLUDE_ACCUMULATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bigint.hpp"
+
+/* A running sum of many BigInts that defers carrying.
+ *
+ * The sum is kept as signed 64 bit lanes, each holding the (unnormalised)
+ * coefficient of one power of 2^32. Adding a value just adds each of its
+ * words into its lane, with no carries running between them, so every
+ * operation is one independent pass that the compiler can vectorise. Each
+ * operation moves a lane by less than 2^33, which leaves room for hundreds
+ * of millions of them before the carries have to be propagated; that happens
+ * automatically, and in result().
+ */
+class BigIntAccumulator
+{
+public:
+	BigIntAccumulator();
+
+	void add(const BigInt& value);
+	void sub(const BigInt& value);
+
+	/* Add value * factor. */
+	void addmul(const BigInt& value, const uint32_t factor);
+
+	/* The sum so far; the accumulator can keep going afterwards. */
+	BigInt result() const;
+
+private:
+	/* Operations between normalisations, each moving a lane by < 2^33. */
+	static const size_t maxPending = size_t(1) << 29;
+
+	std::vector<int64_t> lanes;
+	size_t pending;
+
+	void accumulate(const BigInt& value, const bool negative);
+
+	/* Make room for count lanes, normalising first if the lanes are full. */
+	int64_t* prepare(const size_t count);
+
+	/* Carry every lane into [0, 2^32) except the top one, which keeps the
+	 * sign and stays within [-2^32, 2^32).
+	 */
+	void normalize();
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef INCLUDE_BATCH_HPP
+#define INCLUDE_BATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bigint.hpp"
+
+/* Many non-negative integers of the same fixed width, processed together.
+ *
+ * The values are stored structure-of-arrays: word j of every value is
+ * contiguous, so one SIMD instruction works on the same word of several
+ * values at once and there are no carries between the lanes. Arithmetic is
+ * lane by lane and modulo 2^(32 words()), like FixedInt, except that
+ * products are full width.
+ *
+ * The kernel is chosen at startup from what the CPU supports, and can be
+ * set to any other supported kernel (mainly for testing and benchmarks).
+ */
+class BigIntBatch
+{
+public:
+	enum class Kernel { Scalar, AVX2, AVX512 };
+
+	static Kernel kernel;
+	static bool supported(const Kernel kernel);
+
+	/* count zeros, each words words wide. */
+	BigIntBatch(const size_t count, const size_t words);
+
+	/* Throws std::invalid_argument for a value that is negative or wider
+	 * than words words.
+	 */
+	BigIntBatch(const std::vector<BigInt>& values, const size_t words);
+
+	operator std::vector<BigInt>() const;
+
+	size_t size() const;
+	size_t words() const;
+
+	/* Both operands must have the same size() and words(). */
+	BigIntBatch operator+(const BigIntBatch& that) const;
+	BigIntBatch operator-(const BigIntBatch& that) const;
+
+	BigIntBatch& operator+=(const BigIntBatch& that);
+	BigIntBatch& operator-=(const BigIntBatch& that);
+
+	/* The full products, words() + that.words() words wide; only the sizes
+	 * must match.
+	 */
+	BigIntBatch operator*(const BigIntBatch& that) const;
+
+private:
+	friend class BatchMontgomery;
+
+	/* Lanes are padded to a multiple of the widest kernel's. */
+	static const size_t lanes = 8;
+
+	size_t count;
+	size_t stride;
+	size_t width;
+
+	std::vector<uint32_t> limbs;
+
+	void requireShape(const BigIntBatch& that, const bool sameWidth) const;
+
+	/* The same value in every lane. */
+	static BigIntBatch filled(const size_t count, const BigInt& value, const size_t words);
+};
+
+/* Montgomery arithmetic on batches modulo one odd modulus, whose values
+ * must all be less than the modulus and exactly as wide as it.
+ */
+class BatchMontgomery
+{
+public:
+	explicit BatchMontgomery(const BigInt& modulus);
+
+	size_t words() const;
+
+	/* a * b mod m. */
+	BigIntBatch mulmod(const BigIntBatch& a, const BigIntBatch& b) const;
+
+	/* a * b / R mod m, where R = 2^(32 words()), and the conversions in and
+	 * out of that form (x R mod m), for chains of multiplications.
+	 */
+	BigIntBatch multiply(const BigIntBatch& a, const BigIntBatch& b) const;
+	BigIntBatch toMontgomery(const BigIntBatch& a) const;
+	BigIntBatch fromMontgomery(const BigIntBatch& a) const;
+
+private:
+	std::vector<uint32_t> modulus;
+	uint32_t inverse;
+	BigInt rSquared;
+};
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef INCLUDE_BATCHKERNELS_HPP
+#define INCLUDE_BATCHKERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/* The kernels behind BigIntBatch, private to src/batch*.cpp.
+ *
+ * Each algorithm is written once against a Lanes type, which supplies a
+ * vector of 64 bit lanes and the handful of operations on it the kernels
+ * need: loading 32 bit words into the low halves of the lanes, storing the
+ * low halves back, 64 bit addition and subtraction, the 32 x 32 -> 64 bit
+ * multiplication of the low halves, splitting a lane into its halves, and a
+ * lane-wise select. The scalar, AVX2 and AVX-512 files each instantiate the
+ * algorithms with their own Lanes; everything here has internal linkage so
+ * that code built for one instruction set never stands in for another's.
+ * Those files include this after switching their instruction set on.
+ *
+ * Words are interleaved: word j of lane i is at j * stride + i, and stride
+ * is a multiple of every Lanes::lanes.
+ */
+struct BatchKernels
+{
+	/* r = a + b and r = a - b, modulo 2^(32 words). */
+	void (*add)(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t words, size_t stride);
+	void (*subtract)(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t words, size_t stride);
+
+	/* r = a * b, where r is aWords + bWords long and does not overlap a or b. */
+	void (*multiply)(uint32_t* r, const uint32_t* a, size_t aWords, const uint32_t* b, size_t bWords,
+		size_t stride);
+
+	/* r = a * b / 2^(32 words) mod m, for a, b < m, where m is odd and
+	 * inverse is -1 / m modulo 2^32. scratch holds (words + 2) * 8 words.
+	 */
+	void (*montgomery)(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* m,
+		uint32_t inverse, size_t words, size_t stride, uint32_t* scratch);
+};
+
+/* Null where the compiler or architecture lacks the instruction set. */
+extern const BatchKernels scalarBatchKernels;
+extern const BatchKernels* const avx2BatchKernels;
+extern const BatchKernels* const avx512BatchKernels;
+
+namespace
+{
+	template <typename Lanes>
+	void batchAdd(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t words, size_t stride)
+	{
+		typedef typename Lanes::Vector Vector;
+
+		for (size_t lane = 0; lane < stride; lane += Lanes::lanes)
+		{
+			Vector carry = Lanes::broadcast(0);
+
+			for (size_t j = 0; j < words; j++)
+			{
+				const size_t k = j * stride + lane;
+				Vector sum = Lanes::add(Lanes::add(Lanes::load(a + k), Lanes::load(b + k)), carry);
+
+				Lanes::store(r + k, sum);
+				carry = Lanes::high(sum);
+			}
+		}
+	}
+
+	template <typename Lanes>
+	void batchSubtract(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t words, size_t stride)
+	{
+		typedef typename Lanes::Vector Vector;
+
+		const Vector base = Lanes::broadcast(uint64_t(1) << 32), one = Lanes::broadcast(1);
+
+		for (size_t lane = 0; lane < stride; lane += Lanes::lanes)
+		{
+			Vector borrow = Lanes::broadcast(0);
+
+			/* a + 2^32 - b - borrow is in [0, 2^33), and its high half is 1
+			 * exactly when nothing was borrowed.
+			 */
+			for (size_t j = 0; j < words; j++)
+			{
+				const size_t k = j * stride + lane;
+				Vector difference = Lanes::sub(Lanes::add(Lanes::load(a + k), base),
+					Lanes::add(Lanes::load(b + k), borrow));
+
+				Lanes::store(r + k, difference);
+				borrow = Lanes::sub(one, Lanes::high(difference));
+			}
+		}
+	}
+
+	template <typename Lanes>
+	void batchMultiply(uint32_t* r, const uint32_t* a, size_t aWords, const uint32_t* b, size_t bWords,
+		size_t stride)
+	{
+		typedef typename Lanes::Vector Vector;
+
+		for (size_t lane = 0; lane < stride; lane += Lanes::lanes)
+		{
+			for (size_t j = 0; j < aWords + bWords; j++)
+				Lanes::store(r + j * stride + lane, Lanes::broadcast(0));
+
+			/* (2^32 - 1)^2 plus two words still fits in 64 bits. */
+			for (size_t i = 0; i < aWords; i++)
+			{
+				Vector word = Lanes::load(a + i * stride + lane), carry = Lanes::broadcast(0);
+
+				for (size_t j = 0; j < bWords; j++)
+				{
+					const size_t k = (i + j) * stride + lane;
+					Vector product = Lanes::add(Lanes::add(Lanes::mul(word, Lanes::load(b + j * stride + lane)),
+						Lanes::load(r + k)), carry);
+
+					Lanes::store(r + k, product);
+					carry = Lanes::high(product);
+				}
+
+				Lanes::store(r + (i + bWords) * stride + lane, carry);
+			}
+		}
+	}
+
+	/* Montgomery multiplication interleaving each word of a with one word of
+	 * reduction (CIOS), in words + 2 words of scratch per lane.
+	 */
+	template <typename Lanes>
+	void batchMontgomery(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* m,
+		uint32_t inverse, size_t words, size_t stride, uint32_t* scratch)
+	{
+		typedef typename Lanes::Vector Vector;
+
+		const size_t s = Lanes::lanes;
+		const Vector base = Lanes::broadcast(uint64_t(1) << 32), one = Lanes::broadcast(1);
+		const Vector minusInverse = Lanes::broadcast(inverse);
+		uint32_t* t = scratch;
+
+		for (size_t lane = 0; lane < stride; lane += Lanes::lanes)
+		{
+			for (size_t j = 0; j < words + 2; j++)
+				Lanes::store(t + j * s, Lanes::broadcast(0));
+
+			for (size_t i = 0; i < words; i++)
+			{
+				/* t += a[i] * b */
+				Vector word = Lanes::load(a + i * stride + lane), carry = Lanes::broadcast(0);
+
+				for (size_t j = 0; j < words; j++)
+				{
+					Vector x = Lanes::add(Lanes::add(Lanes::mul(word, Lanes::load(b + j * stride + lane)),
+						Lanes::load(t + j * s)), carry);
+
+					Lanes::store(t + j * s, x);
+					carry = Lanes::high(x);
+				}
+
+				Vector top = Lanes::add(Lanes::load(t + words * s), carry);
+				Lanes::store(t + words * s, top);
+				Lanes::store(t + (words + 1) * s, Lanes::high(top));
+
+				/* t = (t + q m) / 2^32, with q chosen to clear the low word. */
+				Vector q = Lanes::low(Lanes::mul(Lanes::load(t), minusInverse));
+				Vector x = Lanes::add(Lanes::mul(q, Lanes::broadcast(m[0])), Lanes::load(t));
+				carry = Lanes::high(x);
+
+				for (size_t j = 1; j < words; j++)
+				{
+					x = Lanes::add(Lanes::add(Lanes::mul(q, Lanes::broadcast(m[j])), Lanes::load(t + j * s)), carry);
+
+					Lanes::store(t + (j - 1) * s, x);
+					carry = Lanes::high(x);
+				}
+
+				x = Lanes::add(Lanes::load(t + words * s), carry);
+				Lanes::store(t + (words - 1) * s, x);
+				Lanes::store(t + words * s, Lanes::add(Lanes::load(t + (words + 1) * s), Lanes::high(x)));
+			}
+
+			/* t < 2m, so at most one m comes off: r = t - m unless that
+			 * borrows past t's top word.
+			 */
+			Vector borrow = Lanes::broadcast(0);
+
+			for (size_t j = 0; j < words; j++)
+			{
+				Vector difference = Lanes::sub(Lanes::add(Lanes::load(t + j * s), base),
+					Lanes::add(Lanes::broadcast(m[j]), borrow));
+
+				Lanes::store(r + j * stride + lane, difference);
+				borrow = Lanes::sub(one, Lanes::high(difference));
+			}
+
+			Vector reduce = Lanes::add(Lanes::load(t + words * s), Lanes::sub(one, borrow));
+
+			for (size_t j = 0; j < words; j++)
+				Lanes::store(r + j * stride + lane,
+					Lanes::select(reduce, Lanes::load(r + j * stride + lane), Lanes::load(t + j * s)));
+		}
+	}
+}
+
+#endif
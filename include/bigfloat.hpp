@@ -0,0 +1,140 @@
+#ifndef INCLUDE_BIGFLOAT_HPP
+#define INCLUDE_BIGFLOAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "bigint.hpp"
+
+/* A binary floating point number, mantissa() * 2^exponent(), whose mantissa
+ * is a BigInt of at most precision() bits.
+ *
+ * Every operation is computed as if exactly and then rounded once to the
+ * precision of the more precise operand, in the direction given by
+ * BigFloat::rounding, so results at 53 bits match IEEE doubles in their
+ * normal range. The mantissa is kept odd (or zero), so each value has one
+ * representation whatever its precision. There are no infinities, NaNs or
+ * negative zero; invalid operations throw std::invalid_argument, as for
+ * BigInt.
+ */
+class BigFloat
+{
+public:
+	enum class Rounding { ToNearest, TowardZero, TowardNegative, TowardPositive };
+
+	/* Ties to even under ToNearest. */
+	static Rounding rounding;
+
+	/* In bits, for values constructed without one. */
+	static size_t defaultPrecision;
+
+	BigFloat();
+	BigFloat(const BigInt& value, const size_t precision = defaultPrecision);
+
+	/* Throws std::invalid_argument for an infinity or NaN. */
+	explicit BigFloat(const double value, const size_t precision = defaultPrecision);
+
+	/* Decimal, with an optional fraction and exponent ("-12.5e-3"), rounded
+	 * correctly. Throws std::invalid_argument if str is not a number, and
+	 * std::overflow_error if its exponent is beyond what a BigInt shift can
+	 * reach; operator>> sets failbit for either.
+	 */
+	explicit BigFloat(const std::string& str, const size_t precision = defaultPrecision);
+
+	BigFloat(const BigFloat& that) = default;
+	BigFloat(BigFloat&& that) = default;
+
+	BigFloat& operator=(const BigFloat& that);
+	BigFloat& operator=(BigFloat&& that) = default;
+
+	/* Truncated toward zero. */
+	explicit operator BigInt() const;
+
+	/* Enough decimal digits to read back as the same value. */
+	operator std::string() const;
+
+	/* d significant digits, rounded to nearest, as d.ddde+XX. */
+	std::string toScientific(const size_t digits) const;
+
+	/* digits digits after the point, rounded to nearest. */
+	std::string toFixed(const size_t digits) const;
+
+	/* Output honours std::fixed and std::scientific with the stream's
+	 * precision, and otherwise writes operator std::string(). Input reads the
+	 * format of the string constructor at the value's current precision.
+	 */
+	friend std::ostream& operator<<(std::ostream& out, const BigFloat& value);
+	friend std::istream& operator>>(std::istream& in, BigFloat& value);
+
+	size_t precision() const;
+
+	/* Round to a new precision, which must be at least one bit. */
+	void setPrecision(const size_t bits);
+
+	const BigInt& mantissa() const;
+	int64_t exponent() const;
+
+	bool isZero() const;
+	bool isNegative() const;
+
+	bool operator==(const BigFloat& that) const;
+	bool operator!=(const BigFloat& that) const;
+	bool operator<(const BigFloat& that) const;
+	bool operator>(const BigFloat& that) const;
+	bool operator<=(const BigFloat& that) const;
+	bool operator>=(const BigFloat& that) const;
+
+	BigFloat operator-() const;
+
+	BigFloat operator+(const BigFloat& that) const;
+	BigFloat operator-(const BigFloat& that) const;
+	BigFloat operator*(const BigFloat& that) const;
+	BigFloat operator/(const BigFloat& that) const;
+
+	BigFloat& operator+=(const BigFloat& that);
+	BigFloat& operator-=(const BigFloat& that);
+	BigFloat& operator*=(const BigFloat& that);
+	BigFloat& operator/=(const BigFloat& that);
+
+	friend BigFloat sqrt(const BigFloat& value);
+
+private:
+	BigInt significand;
+	int64_t scale;
+	size_t width;
+
+	/* Set this to the magnitude * 2^exponent, negated if asked, rounded to
+	 * precision bits. inexact says whether the true value lies strictly
+	 * beyond the magnitude (away from zero) by less than one of its units;
+	 * the magnitude must then have more than precision bits, so that the
+	 * rounding point falls inside it.
+	 */
+	void assignRounded(BigInt&& magnitude, const bool negative, const int64_t exponent,
+		const bool inexact, const size_t precision);
+
+	/* Set this to numerator / denominator * 2^exponent, for positive
+	 * magnitudes, rounded to precision bits.
+	 */
+	void assignQuotient(BigInt&& numerator, const BigInt& denominator, const bool negative,
+		const int64_t exponent, const size_t precision);
+
+	/* exponent() + mantissa().size(): |x| is in [2^(top - 1), 2^top). */
+	int64_t top() const;
+
+	int compare(const BigFloat& that) const;
+
+	/* |x| * 10^shift, rounded to the nearest integer. */
+	BigInt scaledToInteger(const int64_t shift) const;
+
+	/* The first digits significant decimal digits of |x|, rounded to
+	 * nearest, with the power of ten of the first of them.
+	 */
+	std::string decimalDigits(const size_t digits, int64_t& exponent10) const;
+};
+
+/* Correctly rounded; throws std::invalid_argument for a negative value. */
+BigFloat sqrt(const BigFloat& value);
+
+#endif
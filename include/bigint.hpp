@@ -4,9 +4,15 @@
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <map>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include "sharedwords.hpp"
+
+
+class MappedBigInt;
 
 class BigInt
 {
@@ -20,23 +26,49 @@ public:
 	BigInt& operator=(BigInt& that);
 	BigInt& operator=(BigInt&& that);
 
+	/* Built-in integers are used directly rather than through a temporary
+	 * BigInt. Division by a signed one floors, and its remainder takes the
+	 * sign of the divisor, exactly as for a BigInt divisor, so that
+	 * BigInt(-7) / 3 == -3 and BigInt(-7) % 3 == 2. Division by an unsigned
+	 * one works on the magnitude and keeps the sign, and the remainder is
+	 * that of the magnitude, as the uint32_t operators always have:
+	 * BigInt(-7) / 3u == -2 and BigInt(-7) % 3u == 1.
+	 */
 	bool operator==(const BigInt& that) const;
 	bool operator==(const uint32_t that) const;
+	bool operator==(const int that) const;
+	bool operator==(const int64_t that) const;
+	bool operator==(const uint64_t that) const;
 
 	bool operator!=(const BigInt& that) const;
 	bool operator!=(const uint32_t that) const;
+	bool operator!=(const int that) const;
+	bool operator!=(const int64_t that) const;
+	bool operator!=(const uint64_t that) const;
 
 	bool operator<(const BigInt& that) const;
 	bool operator<(const uint32_t that) const;
+	bool operator<(const int that) const;
+	bool operator<(const int64_t that) const;
+	bool operator<(const uint64_t that) const;
 
 	bool operator>(const BigInt& that) const;
 	bool operator>(const uint32_t that) const;
+	bool operator>(const int that) const;
+	bool operator>(const int64_t that) const;
+	bool operator>(const uint64_t that) const;
 
 	bool operator<=(const BigInt& that) const;
 	bool operator<=(const uint32_t that) const;
+	bool operator<=(const int that) const;
+	bool operator<=(const int64_t that) const;
+	bool operator<=(const uint64_t that) const;
 
 	bool operator>=(const BigInt& that) const;
 	bool operator>=(const uint32_t that) const;
+	bool operator>=(const int that) const;
+	bool operator>=(const int64_t that) const;
+	bool operator>=(const uint64_t that) const;
 
 	BigInt operator-() const;
 	void negate();
@@ -48,48 +80,186 @@ public:
 	BigInt& operator--(const int);
 
 	BigInt operator+(const BigInt& that) const;
+	BigInt operator+(const int that) const;
+	BigInt operator+(const uint32_t that) const;
+	BigInt operator+(const int64_t that) const;
+	BigInt operator+(const uint64_t that) const;
 
 	BigInt operator-(const BigInt& that) const;
+	BigInt operator-(const int that) const;
+	BigInt operator-(const uint32_t that) const;
+	BigInt operator-(const int64_t that) const;
+	BigInt operator-(const uint64_t that) const;
 
 	BigInt operator/(const BigInt& that) const;
 	BigInt operator/(const uint32_t that) const;
+	BigInt operator/(const int that) const;
+	BigInt operator/(const int64_t that) const;
+	BigInt operator/(const uint64_t that) const;
 
 	BigInt operator*(const BigInt& that) const;
 	BigInt operator*(const uint32_t that) const;
+	BigInt operator*(const int that) const;
+	BigInt operator*(const int64_t that) const;
+	BigInt operator*(const uint64_t that) const;
 	
 	BigInt operator%(const BigInt& that) const;
 	uint32_t operator%(const uint32_t that) const;
+	int operator%(const int that) const;
+	int64_t operator%(const int64_t that) const;
+	uint64_t operator%(const uint64_t that) const;
 
 	BigInt operator<<(const uint32_t that) const;
 
 	BigInt operator>>(const uint32_t that) const;
 
+	/* Bitwise operators treat negative values as their (infinitely sign
+	 * extended) two's complement, so ~x == -x - 1.
+	 */
+	BigInt operator&(const BigInt& that) const;
+
+	BigInt operator|(const BigInt& that) const;
+
+	BigInt operator^(const BigInt& that) const;
+
+	BigInt operator~() const;
+
 	BigInt& operator+=(const BigInt& that);
+	BigInt& operator+=(const int that);
+	BigInt& operator+=(const uint32_t that);
+	BigInt& operator+=(const int64_t that);
+	BigInt& operator+=(const uint64_t that);
 
 	BigInt& operator-=(const BigInt& that);
+	BigInt& operator-=(const int that);
+	BigInt& operator-=(const uint32_t that);
+	BigInt& operator-=(const int64_t that);
+	BigInt& operator-=(const uint64_t that);
 
 	BigInt& operator/=(const BigInt& that);
 	BigInt& operator/=(const uint32_t that);
+	BigInt& operator/=(const int that);
+	BigInt& operator/=(const int64_t that);
+	BigInt& operator/=(const uint64_t that);
 
 	BigInt& operator*=(const BigInt& that);
 	BigInt& operator*=(const uint32_t that);
+	BigInt& operator*=(const int that);
+	BigInt& operator*=(const int64_t that);
+	BigInt& operator*=(const uint64_t that);
 
 	BigInt& operator%=(const BigInt& that);
+	BigInt& operator%=(const int that);
+	BigInt& operator%=(const uint32_t that);
+	BigInt& operator%=(const int64_t that);
+	BigInt& operator%=(const uint64_t that);
+
+	/* Every other integral type, such as long long where int64_t is long,
+	 * would match the overloads above equally well, so it goes to the 64-bit
+	 * one of its signedness instead. The overloads above are exact matches
+	 * for their own types and so are still chosen for them.
+	 */
+	template <typename T>
+	using Widened = typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value,
+		typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type>::type;
+
+	template <typename T, typename W = Widened<T>> bool operator==(const T that) const { return *this == W(that); }
+	template <typename T, typename W = Widened<T>> bool operator!=(const T that) const { return *this != W(that); }
+	template <typename T, typename W = Widened<T>> bool operator<(const T that) const { return *this < W(that); }
+	template <typename T, typename W = Widened<T>> bool operator>(const T that) const { return *this > W(that); }
+	template <typename T, typename W = Widened<T>> bool operator<=(const T that) const { return *this <= W(that); }
+	template <typename T, typename W = Widened<T>> bool operator>=(const T that) const { return *this >= W(that); }
+
+	template <typename T, typename W = Widened<T>> BigInt operator+(const T that) const { return *this + W(that); }
+	template <typename T, typename W = Widened<T>> BigInt operator-(const T that) const { return *this - W(that); }
+	template <typename T, typename W = Widened<T>> BigInt operator*(const T that) const { return *this * W(that); }
+	template <typename T, typename W = Widened<T>> BigInt operator/(const T that) const { return *this / W(that); }
+	template <typename T, typename W = Widened<T>> W operator%(const T that) const { return *this % W(that); }
+
+	template <typename T, typename W = Widened<T>> BigInt& operator+=(const T that) { return *this += W(that); }
+	template <typename T, typename W = Widened<T>> BigInt& operator-=(const T that) { return *this -= W(that); }
+	template <typename T, typename W = Widened<T>> BigInt& operator*=(const T that) { return *this *= W(that); }
+	template <typename T, typename W = Widened<T>> BigInt& operator/=(const T that) { return *this /= W(that); }
+	template <typename T, typename W = Widened<T>> BigInt& operator%=(const T that) { return *this %= W(that); }
 
 	BigInt& operator<<=(const uint32_t that);
 
 	BigInt& operator>>=(const uint32_t that);
 
+	BigInt& operator&=(const BigInt& that);
+
+	BigInt& operator|=(const BigInt& that);
+
+	BigInt& operator^=(const BigInt& that);
+
 	operator std::string() const;
 
+	friend std::ostream& operator<<(std::ostream& out, const BigInt& value);
+	friend std::istream& operator>>(std::istream& in, BigInt& value);
+
 	bool isZero() const;
 	bool isPositive() const;
 	bool isNegative() const;
 
 	size_t size() const;
 
+	/* Storage, in bits: reserve room for values of up to bits bits, report
+	 * the room there is, and give back whatever the value doesn't use.
+	 */
+	void reserve(const size_t bits);
+	size_t capacity() const;
+	void shrink_to_fit();
+
+	/* testBit and setBit use two's complement like the bitwise operators.
+	 * popcount counts the set bits of the magnitude, and zero has no
+	 * trailing zeros.
+	 */
+	size_t popcount() const;
+	size_t countTrailingZeros() const;
+	bool testBit(const size_t bit) const;
+	void setBit(const size_t bit, const bool value = true);
+
+	/* Exact division, for when that is known to divide this, works up from
+	 * the low words (Hensel division) and costs about one multiplication.
+	 * The result is meaningless if that does not divide this.
+	 */
+	BigInt divexact(const BigInt& that) const;
+	BigInt divexact(const uint32_t that) const;
+
+	/* Whether that divides this; only zero is divisible by zero. */
+	bool divisible(const BigInt& that) const;
+	bool divisible(const uint32_t that) const;
+
+	/* Write the value to path in the format described in mapped.hpp, and map
+	 * such a file back read-only without copying its words. The file is
+	 * written beside path and renamed over it, so whatever still maps the old
+	 * file, this value included, keeps reading the old words.
+	 */
+	void save(const std::string& path) const;
+	static MappedBigInt mapFile(const std::string& path);
+
+	/* Algorithm cutovers, initialised from tuning.hpp. */
+	static size_t karatsubaThreshold;
+	static size_t parseThreshold;
+
 private:
-	typedef std::vector<uint32_t> Words;
+	template <size_t Bits> friend class FixedInt;
+	friend class MappedBigInt;
+	friend class DiskStore;
+	friend class BigIntAccumulator;
+	friend class BigIntBatch;
+	friend class BatchMontgomery;
+	friend class ModularContext;
+	template <char... Digits> friend BigInt operator"" _big();
+	friend BigInt gcd(const BigInt& a, const BigInt& b);
+	friend std::vector<uint32_t> residues(const BigInt& x, const std::vector<uint32_t>& moduli);
+
+	/* Copies share their words until one of them writes; see sharedwords.hpp. */
+	typedef SharedWords Words;
+
+	/* Digits per decimal chunk, and 10 to that power. */
+	static const size_t chunkDigits = 9;
+	static const uint32_t chunkBase = 1000000000;
 
 	static BigInt zero;
 	static BigInt one;
@@ -99,7 +269,7 @@ private:
 	BigInt::Words words;
 
 	BigInt(const BigInt::Words& that, bool sign = true);
-	BigInt(const BigInt::Words&& that, bool sign = true);
+	BigInt(BigInt::Words&& that, bool sign = true);
 
 	BigInt& operator+=(const BigInt::Words& that);
 	
@@ -111,7 +281,51 @@ private:
 
 	void trim();
 
+	/* Reduce a non-negative value modulo 2^(32 count). */
+	void truncateWords(const size_t count);
+
+	/* Kernels for built-in integers, given as a sign and a magnitude. */
+	static uint64_t magnitudeOf(const int64_t that);
+	int compareScalar(const bool negative, const uint64_t magnitude) const;
+	BigInt& addScalar(const bool negative, const uint64_t magnitude);
+	BigInt& multiplyScalar(const bool negative, const uint64_t magnitude);
+	/* Divides the magnitude, truncating, and returns its remainder. */
+	uint64_t divideScalar(const bool negative, const uint64_t magnitude);
+	uint64_t remainderScalar(const uint64_t magnitude) const;
+	void assignScalar(const bool negative, const uint64_t magnitude);
+
+	template <typename Operation>
+	BigInt& bitwise(const BigInt& that, Operation operation);
+
+	Words decimalChunks() const;
+
 	static Words binaryToWords(const std::vector<bool>& binary);
+
+	static BigInt parseDigits(const std::string& str, size_t begin, size_t end,
+		std::map<size_t, BigInt>& powers);
 };
 
+/* Multiply all of values together with a balanced product tree. */
+BigInt productOf(const std::vector<BigInt>& values);
+
+/* The balanced product tree over values, which must not be empty, in
+ * preorder: the node for values [begin, end) comes first, then the subtree
+ * for [begin, mid), then that for [mid, end), where mid = begin + (end -
+ * begin) / 2. The root, the product of all of values, is at index zero.
+ */
+std::vector<BigInt> productTree(const std::vector<BigInt>& values);
+
+/* Compute x % m for every (positive) m in moduli with a remainder tree. */
+std::vector<BigInt> remaindersOf(const BigInt& x, const std::vector<BigInt>& moduli);
+
+/* The greatest common divisor of |a| and |b|, which is zero only for two
+ * zeros.
+ */
+BigInt gcd(const BigInt& a, const BigInt& b);
+
+/* Combinatorial functions built from the prime factorization of the result. */
+BigInt factorial(const uint32_t n);
+BigInt binomial(const uint32_t n, const uint32_t k);
+BigInt primorial(const uint32_t n);
+
 #endif
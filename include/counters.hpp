@@ -0,0 +1,97 @@
+#ifndef INCLUDE_COUNTERS_HPP
+#define INCLUDE_COUNTERS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Operation counters.
+ *
+ * When built with BIGINT_INSTRUMENT defined (`make INSTRUMENT=1`), the
+ * library counts calls, words processed (nine digit chunks when parsing),
+ * buffer allocations and time spent in each operation and algorithm tier.
+ *
+ * Every BigInt buffer counts against the innermost operation running on its
+ * thread, so the multiplications inside a parse or a division count as
+ * multiplications; other scratch buffers are counted where they are made.
+ * An operation running inside another on the same thread counts its call
+ * but not its time, which is its caller's. Otherwise the counting macros
+ * compile to nothing and snapshots are all zero.
+ */
+
+enum class Counter
+{
+	Multiply,
+	MultiplySchoolbook,
+	MultiplyKaratsuba,
+	MultiplyWord,
+	Divide,
+	DivideWord,
+	Modulo,
+	ToString,
+	Parse,
+	ParseChunked,
+	ParseSplit,
+	Count
+};
+
+struct CounterValues
+{
+	std::string name;
+	uint64_t calls;
+	uint64_t limbs;
+	uint64_t allocations;
+	uint64_t nanoseconds;
+};
+
+std::vector<CounterValues> snapshotCounters();
+void resetCounters();
+
+#ifdef BIGINT_INSTRUMENT
+
+void countCall(Counter counter, size_t limbs);
+void countAllocation(Counter counter);
+void countTime(Counter counter, uint64_t nanoseconds);
+
+/* Counts an allocation against the innermost CounterScope on this thread,
+ * if there is one.
+ */
+void countScopeAllocation();
+
+/* Counts a call on construction and, unless it is inside another scope on
+ * the same thread, the time until destruction.
+ */
+class CounterScope
+{
+public:
+	CounterScope(Counter counter, size_t limbs);
+	~CounterScope();
+
+	CounterScope(const CounterScope&) = delete;
+	CounterScope& operator=(const CounterScope&) = delete;
+
+private:
+	friend void countScopeAllocation();
+
+	Counter counter;
+	CounterScope* outer;
+	std::chrono::steady_clock::time_point start;
+};
+
+#define BIGINT_TIME(counter, limbs) CounterScope counterScope((counter), (limbs))
+#define BIGINT_COUNT(counter, limbs) countCall((counter), (limbs))
+#define BIGINT_ALLOCATION(counter) countAllocation(counter)
+#define BIGINT_SCOPE_ALLOCATION() countScopeAllocation()
+
+#else
+
+#define BIGINT_TIME(counter, limbs) do {} while (0)
+#define BIGINT_COUNT(counter, limbs) do {} while (0)
+#define BIGINT_ALLOCATION(counter) do {} while (0)
+#define BIGINT_SCOPE_ALLOCATION() do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef INCLUDE_CRT_HPP
+#define INCLUDE_CRT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bigint.hpp"
+
+/* x mod m for every m in moduli, none of which may be zero, in one pass
+ * over x's words from the top: each word is folded into all of the
+ * residues before the next is read, so x is read once however many moduli
+ * there are, and the residues, independent of each other, keep the
+ * multipliers busy where one remainder at a time would wait on each
+ * division. Each step is a multiplication by a precomputed reciprocal
+ * rather than a division.
+ *
+ * The residues are of x itself, in [0, m), as BigInt's % gives them; for a
+ * negative x that is not the scalar operator%, which is of the magnitude.
+ */
+std::vector<uint32_t> residues(const BigInt& x, const std::vector<uint32_t>& moduli);
+
+/* Reconstruction by the Chinese remainder theorem for a fixed set of
+ * pairwise coprime moduli, with everything that depends only on them
+ * worked out once:
+ *
+ *  - up to garnerLimit moduli, Garner's algorithm, which finds the mixed
+ *    radix digits of the value in word arithmetic, with an inverse per
+ *    modulus, and multiplies them up only at the end;
+ *  - beyond that, the product tree over the moduli, from which the value
+ *    sum of r_i c_i M / m_i, with c_i = (M / m_i)^-1 mod m_i, is built
+ *    from the leaves up as x = x_left M_right + x_right M_left, so every
+ *    product is of balanced halves. The same tree takes values apart again.
+ */
+class CRTContext
+{
+public:
+	/* Throws std::invalid_argument if a modulus is zero or two of them have
+	 * a common factor.
+	 */
+	explicit CRTContext(const std::vector<uint32_t>& moduli);
+
+	size_t size() const;
+	const std::vector<uint32_t>& moduli() const;
+
+	/* M, the product of the moduli. */
+	const BigInt& product() const;
+
+	/* The x in [0, M) with x = residues[i] mod moduli()[i], for a residue
+	 * per modulus.
+	 */
+	BigInt combine(const std::vector<uint32_t>& residues) const;
+
+	/* residues(x, moduli()), reducing x down the product tree first when
+	 * there is one.
+	 */
+	std::vector<uint32_t> reduce(const BigInt& x) const;
+
+private:
+	static const size_t garnerLimit = 64;
+
+	/* The tree is descended only to nodes of this many moduli, and their
+	 * residues taken in one pass.
+	 */
+	static const size_t leafSize = 16;
+
+	std::vector<uint32_t> divisors;
+	BigInt modulus;
+
+	/* For Garner's algorithm, the inverse of the product of the earlier
+	 * moduli modulo each; for the tree, c_i.
+	 */
+	std::vector<uint32_t> inverses;
+
+	/* The product tree as productTree() lays it out, when there is one. */
+	std::vector<BigInt> tree;
+
+	BigInt garner(const std::vector<uint32_t>& residues) const;
+	BigInt ascend(const std::vector<uint32_t>& residues, const size_t node, const size_t begin,
+		const size_t end, const unsigned threads) const;
+	void descend(const BigInt& x, std::vector<uint32_t>& result, const size_t node, const size_t begin,
+		const size_t end) const;
+};
+
+/* CRTContext(moduli).combine(residues), for a single reconstruction. */
+BigInt crt(const std::vector<uint32_t>& residues, const std::vector<uint32_t>& moduli);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef INCLUDE_CT_HPP
+#define INCLUDE_CT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/* Constant-time kernels over fixed-size little endian arrays of n words.
+ *
+ * None of these branch on or index memory by the values of their operands;
+ * their running time depends only on n (and expWords for ct_powmod). The
+ * result arrays may alias the inputs.
+ */
+
+/* r = a + b, returning the carry out of the top word. */
+uint32_t ct_add(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n);
+
+/* r = a - b, returning the borrow out of the top word. */
+uint32_t ct_sub(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n);
+
+/* r = choice ? a : b, where choice is 0 or 1. */
+void ct_select(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n, uint32_t choice);
+
+/* Return 1 if a == b (or a < b), otherwise 0. */
+uint32_t ct_equal(const uint32_t* a, const uint32_t* b, size_t n);
+uint32_t ct_less(const uint32_t* a, const uint32_t* b, size_t n);
+
+/* r = a * b mod m, for any non-zero m. */
+void ct_mulmod(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* m, size_t n);
+
+/* r = base ^ exp mod m, where exp is expWords long. */
+void ct_powmod(uint32_t* r, const uint32_t* base, const uint32_t* exp, size_t expWords,
+	const uint32_t* m, size_t n);
+
+#endif
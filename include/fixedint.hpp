@@ -0,0 +1,506 @@
+#ifndef INCLUDE_FIXEDINT_HPP
+#define INCLUDE_FIXEDINT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "bigint.hpp"
+
+/* A signed integer of exactly Bits bits in two's complement.
+ *
+ * The words live inline, so no operation allocates, and every loop runs a
+ * compile time number of times so the compiler can unroll it. Arithmetic
+ * wraps modulo 2^Bits; as long as nothing overflows, every operator gives
+ * the same result as it would on a BigInt (including flooring division and
+ * a remainder with the sign of the divisor).
+ */
+template <size_t Bits>
+class FixedInt
+{
+	static_assert(Bits > 0 && Bits % 32 == 0, "FixedInt width must be a multiple of 32 bits");
+
+public:
+	static const size_t Words = Bits / 32;
+
+	FixedInt()
+	{
+		words.fill(0);
+	}
+
+	FixedInt(const uint32_t that)
+	{
+		words.fill(0);
+		words[0] = that;
+	}
+
+	explicit FixedInt(const std::string& str)
+		: FixedInt(BigInt(str))
+	{
+	}
+
+	explicit FixedInt(const BigInt& that)
+	{
+		for (size_t i = 0; i < Words; i++)
+			words[i] = i < that.words.size() ? that.words[i] : 0;
+
+		if (that.isNegative())
+			negate();
+	}
+
+	operator BigInt() const
+	{
+		FixedInt magnitude(abs());
+		BigInt::Words result(magnitude.words.data(), magnitude.words.data() + Words);
+		BigInt value(std::move(result), !isNegative());
+
+		value.trim();
+		return value;
+	}
+
+	explicit operator std::string() const
+	{
+		return static_cast<std::string>(static_cast<BigInt>(*this));
+	}
+
+	bool operator==(const FixedInt& that) const
+	{
+		for (size_t i = 0; i < Words; i++)
+			if (words[i] != that.words[i])
+				return false;
+
+		return true;
+	}
+
+	bool operator!=(const FixedInt& that) const
+	{
+		return !(*this == that);
+	}
+
+	bool operator<(const FixedInt& that) const
+	{
+		if (isNegative() != that.isNegative())
+			return isNegative();
+
+		/* With equal signs, two's complement orders like the unsigned words. */
+		for (size_t i = Words; i > 0; i--)
+			if (words[i - 1] != that.words[i - 1])
+				return words[i - 1] < that.words[i - 1];
+
+		return false;
+	}
+
+	bool operator>(const FixedInt& that) const
+	{
+		return that < *this;
+	}
+
+	bool operator<=(const FixedInt& that) const
+	{
+		return !(that < *this);
+	}
+
+	bool operator>=(const FixedInt& that) const
+	{
+		return !(*this < that);
+	}
+
+	FixedInt operator-() const
+	{
+		FixedInt negated(*this);
+		negated.negate();
+		return negated;
+	}
+
+	void negate()
+	{
+		uint64_t carry = 1;
+
+		for (size_t i = 0; i < Words; i++)
+		{
+			uint64_t sum = static_cast<uint64_t>(~words[i]) + carry;
+
+			words[i] = static_cast<uint32_t>(sum);
+			carry = sum >> 32;
+		}
+	}
+
+	FixedInt& operator++()
+	{
+		return *this += FixedInt(1);
+	}
+
+	FixedInt operator++(const int)
+	{
+		FixedInt old(*this);
+		++*this;
+		return old;
+	}
+
+	FixedInt& operator--()
+	{
+		return *this -= FixedInt(1);
+	}
+
+	FixedInt operator--(const int)
+	{
+		FixedInt old(*this);
+		--*this;
+		return old;
+	}
+
+	FixedInt operator+(const FixedInt& that) const
+	{
+		FixedInt copy(*this);
+		copy += that;
+		return copy;
+	}
+
+	FixedInt operator-(const FixedInt& that) const
+	{
+		FixedInt copy(*this);
+		copy -= that;
+		return copy;
+	}
+
+	FixedInt operator*(const FixedInt& that) const
+	{
+		FixedInt copy(*this);
+		copy *= that;
+		return copy;
+	}
+
+	FixedInt operator*(const uint32_t that) const
+	{
+		FixedInt copy(*this);
+		copy *= that;
+		return copy;
+	}
+
+	FixedInt operator/(const FixedInt& that) const
+	{
+		FixedInt copy(*this);
+		copy /= that;
+		return copy;
+	}
+
+	FixedInt operator/(const uint32_t that) const
+	{
+		FixedInt copy(*this);
+		copy /= that;
+		return copy;
+	}
+
+	FixedInt operator%(const FixedInt& that) const
+	{
+		FixedInt copy(*this);
+		copy %= that;
+		return copy;
+	}
+
+	uint32_t operator%(const uint32_t that) const
+	{
+		if (that == 0)
+			throw std::invalid_argument("division by zero");
+
+		FixedInt magnitude(abs());
+		uint64_t remainder = 0;
+
+		for (size_t i = Words; i > 0; i--)
+			remainder = ((remainder << 32) + magnitude.words[i - 1]) % that;
+
+		return static_cast<uint32_t>(remainder);
+	}
+
+	FixedInt operator<<(const uint32_t that) const
+	{
+		FixedInt copy(*this);
+		copy <<= that;
+		return copy;
+	}
+
+	FixedInt operator>>(const uint32_t that) const
+	{
+		FixedInt copy(*this);
+		copy >>= that;
+		return copy;
+	}
+
+	FixedInt& operator+=(const FixedInt& that)
+	{
+		uint64_t carry = 0;
+
+		for (size_t i = 0; i < Words; i++)
+		{
+			uint64_t sum = static_cast<uint64_t>(words[i]) + that.words[i] + carry;
+
+			words[i] = static_cast<uint32_t>(sum);
+			carry = sum >> 32;
+		}
+
+		return *this;
+	}
+
+	FixedInt& operator-=(const FixedInt& that)
+	{
+		uint64_t borrow = 0;
+
+		for (size_t i = 0; i < Words; i++)
+		{
+			uint64_t difference = static_cast<uint64_t>(words[i]) - that.words[i] - borrow;
+
+			words[i] = static_cast<uint32_t>(difference);
+			borrow = difference >> 63;
+		}
+
+		return *this;
+	}
+
+	FixedInt& operator*=(const FixedInt& that)
+	{
+		/* Two's complement multiplication modulo 2^Bits does not care about
+		 * signs, so we only compute the low Words words of the product.
+		 */
+		FixedInt result;
+
+		for (size_t i = 0; i < Words; i++)
+		{
+			uint64_t carry = 0;
+
+			for (size_t j = 0; i + j < Words; j++)
+			{
+				uint64_t product = static_cast<uint64_t>(words[i]) * that.words[j]
+					+ result.words[i + j] + carry;
+
+				result.words[i + j] = static_cast<uint32_t>(product);
+				carry = product >> 32;
+			}
+		}
+
+		return *this = result;
+	}
+
+	FixedInt& operator*=(const uint32_t that)
+	{
+		uint64_t carry = 0;
+
+		for (size_t i = 0; i < Words; i++)
+		{
+			uint64_t product = static_cast<uint64_t>(words[i]) * that + carry;
+
+			words[i] = static_cast<uint32_t>(product);
+			carry = product >> 32;
+		}
+
+		return *this;
+	}
+
+	FixedInt& operator/=(const FixedInt& that)
+	{
+		FixedInt remainder;
+		divide(that, remainder);
+		return *this;
+	}
+
+	FixedInt& operator/=(const uint32_t that)
+	{
+		/* Like BigInt, dividing by a word truncates the magnitude. */
+		if (that == 0)
+			throw std::invalid_argument("division by zero");
+
+		bool negative = isNegative();
+		uint64_t remainder = 0;
+
+		if (negative)
+			negate();
+
+		for (size_t i = Words; i > 0; i--)
+		{
+			remainder = (remainder << 32) + words[i - 1];
+			words[i - 1] = static_cast<uint32_t>(remainder / that);
+			remainder %= that;
+		}
+
+		if (negative)
+			negate();
+
+		return *this;
+	}
+
+	FixedInt& operator%=(const FixedInt& that)
+	{
+		FixedInt remainder;
+		divide(that, remainder);
+		return *this = remainder;
+	}
+
+	FixedInt& operator<<=(const uint32_t that)
+	{
+		if (that >= Bits)
+		{
+			words.fill(0);
+			return *this;
+		}
+
+		size_t wordShifts = that / 32;
+		uint32_t bitShifts = that % 32;
+
+		for (size_t i = Words; i > 0; i--)
+		{
+			size_t source = i - 1;
+			uint32_t word = 0;
+
+			if (source >= wordShifts)
+			{
+				word = words[source - wordShifts] << bitShifts;
+
+				if (bitShifts != 0 && source > wordShifts)
+					word |= words[source - wordShifts - 1] >> (32 - bitShifts);
+			}
+
+			words[source] = word;
+		}
+
+		return *this;
+	}
+
+	FixedInt& operator>>=(const uint32_t that)
+	{
+		/* Like BigInt, shifting right shifts the magnitude and keeps the sign. */
+		bool negative = isNegative();
+
+		if (negative)
+			negate();
+
+		if (that >= Bits)
+			words.fill(0);
+		else
+		{
+			size_t wordShifts = that / 32;
+			uint32_t bitShifts = that % 32;
+
+			for (size_t i = 0; i < Words; i++)
+			{
+				uint32_t word = 0;
+
+				if (i + wordShifts < Words)
+				{
+					word = words[i + wordShifts] >> bitShifts;
+
+					if (bitShifts != 0 && i + wordShifts + 1 < Words)
+						word |= words[i + wordShifts + 1] << (32 - bitShifts);
+				}
+
+				words[i] = word;
+			}
+		}
+
+		if (negative)
+			negate();
+
+		return *this;
+	}
+
+	bool isZero() const
+	{
+		uint32_t bits = 0;
+
+		for (size_t i = 0; i < Words; i++)
+			bits |= words[i];
+
+		return bits == 0;
+	}
+
+	bool isPositive() const
+	{
+		return !isNegative();
+	}
+
+	bool isNegative() const
+	{
+		return (words[Words - 1] >> 31) != 0;
+	}
+
+	size_t size() const
+	{
+		FixedInt magnitude(abs());
+
+		for (size_t i = Words; i > 0; i--)
+		{
+			if (magnitude.words[i - 1] != 0)
+			{
+				size_t size = 32 * (i - 1);
+				for (uint32_t msb = magnitude.words[i - 1]; msb != 0; msb >>= 1)
+					size++;
+
+				return size;
+			}
+		}
+
+		return 0;
+	}
+
+private:
+	std::array<uint32_t, Words> words;
+
+	FixedInt abs() const
+	{
+		return isNegative() ? -*this : *this;
+	}
+
+	/* Replace this with the floored quotient by that and store the remainder
+	 * (which has the sign of that) in remainder.
+	 */
+	void divide(const FixedInt& that, FixedInt& remainder)
+	{
+		if (that.isZero())
+			throw std::invalid_argument("division by zero");
+
+		bool negativeDividend = isNegative(), negativeDivisor = that.isNegative();
+		FixedInt dividend(abs()), divisor(that.abs()), quotient;
+
+		remainder = FixedInt();
+
+		/* Restoring division, one bit of the dividend at a time. */
+		for (size_t i = Bits; i > 0; i--)
+		{
+			remainder <<= 1;
+			remainder.words[0] |= (dividend.words[(i - 1) / 32] >> ((i - 1) % 32)) & 1;
+
+			if (!remainder.lessUnsigned(divisor))
+			{
+				remainder -= divisor;
+				quotient.words[(i - 1) / 32] |= 1u << ((i - 1) % 32);
+			}
+		}
+
+		if (negativeDividend != negativeDivisor)
+		{
+			quotient.negate();
+
+			if (!remainder.isZero())
+			{
+				--quotient;
+				remainder = divisor - remainder;
+			}
+		}
+
+		if (negativeDivisor)
+			remainder.negate();
+
+		*this = quotient;
+	}
+
+	bool lessUnsigned(const FixedInt& that) const
+	{
+		for (size_t i = Words; i > 0; i--)
+			if (words[i - 1] != that.words[i - 1])
+				return words[i - 1] < that.words[i - 1];
+
+		return false;
+	}
+};
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef INCLUDE_LITERAL_HPP
+#define INCLUDE_LITERAL_HPP
+
+#include <cstdint>
+#include <iterator>
+
+#include "bigint.hpp"
+
+/* BigInt literals, e.g. 123456789012345678901234567890_big.
+ *
+ * The decimal digits are converted to words by the compiler, so at run time
+ * constructing the literal only copies a constant array of words.
+ *
+ * The digits are taken nine at a time and the words four at a time, so a
+ * literal of n digits nests templates about n / 9 + n / 38 deep. With the
+ * usual limit of 900 that allows roughly 5000 digits (about 16000 bits);
+ * longer values should be parsed from strings at run time.
+ */
+namespace literal
+{
+	template <uint32_t... Words>
+	struct WordList
+	{
+		static const uint32_t words[sizeof...(Words)];
+	};
+
+	template <uint32_t... Words>
+	const uint32_t WordList<Words...>::words[sizeof...(Words)] = { Words... };
+
+	constexpr uint64_t digit(const char c)
+	{
+		return static_cast<uint64_t>(c - '0');
+	}
+
+	constexpr bool decimal(const char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	/* Multiply the little endian words by Multiplier (at most 10^9) and add
+	 * Carry (the next digits), moving each word from the input pack onto Done
+	 * as we go.
+	 */
+	template <uint64_t Multiplier, uint64_t Carry, typename Done, uint32_t... Words>
+	struct MulAdd;
+
+	template <uint64_t Multiplier, uint64_t Carry, uint32_t... Done>
+	struct MulAdd<Multiplier, Carry, WordList<Done...>>
+	{
+		typedef WordList<Done..., static_cast<uint32_t>(Carry)> type;
+	};
+
+	template <uint64_t Multiplier, uint32_t... Done>
+	struct MulAdd<Multiplier, 0, WordList<Done...>>
+	{
+		typedef WordList<Done...> type;
+	};
+
+	template <uint64_t Multiplier, uint64_t Carry, uint32_t... Done, uint32_t First, uint32_t... Rest>
+	struct MulAdd<Multiplier, Carry, WordList<Done...>, First, Rest...>
+		: MulAdd<Multiplier, ((First * Multiplier + Carry) >> 32),
+			WordList<Done..., static_cast<uint32_t>(First * Multiplier + Carry)>, Rest...>
+	{
+	};
+
+	/* The products of four words at once, to keep the recursion shallow. */
+	template <uint64_t Multiplier, uint64_t Carry, uint32_t A, uint32_t B, uint32_t C, uint32_t D>
+	struct Products
+	{
+		static const uint64_t a = A * Multiplier + Carry;
+		static const uint64_t b = B * Multiplier + (a >> 32);
+		static const uint64_t c = C * Multiplier + (b >> 32);
+		static const uint64_t d = D * Multiplier + (c >> 32);
+	};
+
+	template <uint64_t Multiplier, uint64_t Carry, uint32_t... Done, uint32_t A, uint32_t B, uint32_t C, uint32_t D,
+		uint32_t... Rest>
+	struct MulAdd<Multiplier, Carry, WordList<Done...>, A, B, C, D, Rest...>
+		: MulAdd<Multiplier, (Products<Multiplier, Carry, A, B, C, D>::d >> 32),
+			WordList<Done...,
+				static_cast<uint32_t>(Products<Multiplier, Carry, A, B, C, D>::a),
+				static_cast<uint32_t>(Products<Multiplier, Carry, A, B, C, D>::b),
+				static_cast<uint32_t>(Products<Multiplier, Carry, A, B, C, D>::c),
+				static_cast<uint32_t>(Products<Multiplier, Carry, A, B, C, D>::d)>,
+			Rest...>
+	{
+	};
+
+	template <typename Words, char... Digits>
+	struct Parse;
+
+	template <typename Words>
+	struct Parse<Words>
+	{
+		typedef Words type;
+	};
+
+	template <uint32_t... Words, char Digit, char... Digits>
+	struct Parse<WordList<Words...>, Digit, Digits...>
+	{
+		static_assert(decimal(Digit), "BigInt literals must be decimal");
+
+		typedef typename Parse<
+			typename MulAdd<10, digit(Digit), WordList<>, Words...>::type,
+			Digits...>::type type;
+	};
+
+	template <uint32_t... Words, char D0, char D1, char D2, char D3, char D4, char D5, char D6, char D7, char D8,
+		char... Digits>
+	struct Parse<WordList<Words...>, D0, D1, D2, D3, D4, D5, D6, D7, D8, Digits...>
+	{
+		static_assert(decimal(D0) && decimal(D1) && decimal(D2) && decimal(D3) && decimal(D4) && decimal(D5)
+			&& decimal(D6) && decimal(D7) && decimal(D8), "BigInt literals must be decimal");
+
+		static const uint64_t chunk = (((((((digit(D0) * 10 + digit(D1)) * 10 + digit(D2)) * 10 + digit(D3)) * 10
+			+ digit(D4)) * 10 + digit(D5)) * 10 + digit(D6)) * 10 + digit(D7)) * 10 + digit(D8);
+
+		typedef typename Parse<
+			typename MulAdd<1000000000, chunk, WordList<>, Words...>::type,
+			Digits...>::type type;
+	};
+}
+
+template <char... Digits>
+BigInt operator"" _big()
+{
+	typedef typename literal::Parse<literal::WordList<0>, Digits...>::type Words;
+
+	return BigInt(BigInt::Words(std::begin(Words::words), std::end(Words::words)));
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef INCLUDE_MAPPED_HPP
+#define INCLUDE_MAPPED_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "bigint.hpp"
+
+/* A read-only BigInt backed directly by a memory mapped file written with
+ * BigInt::save().
+ *
+ * Converting to BigInt copies nothing: the BigInt borrows the mapped words
+ * (see SharedWords::borrow()), so a mapped value can be used with all of
+ * BigInt's operators, and only a BigInt that is written to, such as the
+ * left side of +=, copies the words into memory of its own. The mapping
+ * lasts until the MappedBigInt and every BigInt made from it are gone, and
+ * the file must not be changed in the meantime.
+ *
+ * The file is a 24 byte header followed by the raw words:
+ *
+ *   offset  0: the magic bytes "BIGINT\0\1"
+ *   offset  8: uint32_t format version (1)
+ *   offset 12: uint32_t flags (bit 0 set if negative)
+ *   offset 16: uint64_t number of words
+ *   offset 24: the words, least significant first
+ *
+ * All fields are little endian. Mapping is shared, so several processes
+ * mapping the same file share one copy of the words in the page cache.
+ */
+class MappedBigInt;
+
+/* The header at the start of a file, as laid out above. */
+struct BigIntFileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t flags;
+	uint64_t count;
+
+	static const uint32_t negativeFlag = 1;
+
+	BigIntFileHeader(bool negative = false, uint64_t count = 0);
+
+	/* Whether this is a version we read, describing a file of fileLength bytes. */
+	bool valid(size_t fileLength) const;
+};
+
+/* Create and open a new file beside path, to be renamed over it once
+ * written, and set temporary to its name. It has the permissions path
+ * already has, or those a new file would be created with if there is none.
+ * Returns -1 on failure.
+ */
+int createReplacement(const std::string& path, std::string& temporary);
+
+class MappedBigInt
+{
+public:
+	MappedBigInt(MappedBigInt&& that);
+	MappedBigInt& operator=(MappedBigInt&& that);
+
+	MappedBigInt(const MappedBigInt&) = delete;
+	MappedBigInt& operator=(const MappedBigInt&) = delete;
+
+	/* A BigInt reading the mapped words in place. */
+	operator BigInt() const;
+
+	const uint32_t* data() const;
+	size_t length() const;
+
+	bool isZero() const;
+	bool isPositive() const;
+	bool isNegative() const;
+
+	size_t size() const;
+
+	/* Whether path names the file this was mapped from, through whatever
+	 * links or renames; false once the file has no name left.
+	 */
+	bool isFile(const std::string& path) const;
+
+private:
+	friend class BigInt;
+
+	MappedBigInt(void* mapping, size_t mappingLength);
+
+	static void unmap(void* mapping, size_t mappingLength);
+
+	/* Every word in the file, leading zeros and all; the block unmaps the
+	 * file once nothing borrows it.
+	 */
+	SharedWords words;
+	bool positive;
+
+	/* The file's identity, as fstat gave it when it was mapped. */
+	uint64_t device;
+	uint64_t inode;
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef INCLUDE_OUTOFCORE_HPP
+#define INCLUDE_OUTOFCORE_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "mapped.hpp"
+
+/* Arithmetic on values too large to hold in memory alongside their
+ * temporaries.
+ *
+ * Operands are files in the format of mapped.hpp (as written by
+ * BigInt::save() or by these functions), and each result is written to a
+ * temporary beside path, renamed over path and returned mapped, so anything
+ * still mapping the old file keeps its words. path must not name an
+ * operand's file; that throws std::invalid_argument. Every pass over a file
+ * is sequential or works on one block of at most diskBlockBytes at a time, so
+ * the working set stays bounded however large the operands are. Temporaries
+ * are scratch files next to path that are unlinked as soon as they are
+ * created.
+ */
+
+/* The memory each pass may use; at least a megabyte is sensible. */
+extern size_t diskBlockBytes;
+
+MappedBigInt diskAdd(const MappedBigInt& a, const MappedBigInt& b, const std::string& path);
+MappedBigInt diskSubtract(const MappedBigInt& a, const MappedBigInt& b, const std::string& path);
+MappedBigInt diskMultiply(const MappedBigInt& a, const MappedBigInt& b, const std::string& path);
+
+/* Radix conversion between a decimal text file (an optional '-' followed by
+ * digits) and the binary format, by divide and conquer over the disk
+ * arithmetic above.
+ */
+MappedBigInt diskFromDecimal(const std::string& decimalPath, const std::string& path);
+void diskToDecimal(const MappedBigInt& value, const std::string& decimalPath);
+
+#endif
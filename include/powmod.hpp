@@ -0,0 +1,124 @@
+#ifndef INCLUDE_POWMOD_HPP
+#define INCLUDE_POWMOD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bigint.hpp"
+
+/* Modular exponentiation with one odd modulus m, in Montgomery form: values
+ * are kept as x R mod m, where R = 2^(32 words()), so that each product is
+ * reduced with word multiplications instead of a division. Setting that up
+ * costs a division, which a context pays once for every exponentiation
+ * done with it.
+ *
+ * Exponents must not be negative; bases may be any integer, and are
+ * reduced modulo m first. A context is not changed by its use, so one may
+ * be shared between threads.
+ */
+class ModularContext
+{
+public:
+	/* Throws std::invalid_argument unless modulus is odd and greater than
+	 * one.
+	 */
+	explicit ModularContext(const BigInt& modulus);
+
+	const BigInt& modulus() const;
+	size_t words() const;
+
+	/* a * b mod m. */
+	BigInt mulmod(const BigInt& a, const BigInt& b) const;
+
+	/* base^exponent mod m, by a sliding window over the exponent. */
+	BigInt powmod(const BigInt& base, const BigInt& exponent) const;
+
+	/* The product of bases[i]^exponents[i] mod m, for the same number of
+	 * each. Rather than an exponentiation per base, every base shares one
+	 * chain of squarings, with either
+	 *
+	 *  - Straus's method: each base gets its own sliding window and table
+	 *    of odd powers, and its windows are multiplied in as the chain
+	 *    passes them, or
+	 *  - Pippenger's: the exponents are cut into c-bit digits, and for each
+	 *    digit position the bases are sorted into buckets by digit, whose
+	 *    products are weighted by running products, at about one
+	 *    multiplication per base and digit with no tables at all.
+	 *
+	 * whichever an estimate of the multiplications each takes favours;
+	 * Pippenger's for many bases.
+	 */
+	BigInt multiPowmod(const std::vector<BigInt>& bases, const std::vector<BigInt>& exponents) const;
+
+private:
+	friend class FixedBasePowmod;
+
+	/* A value below m, in exactly words() words. */
+	typedef std::vector<uint32_t> Residue;
+
+	BigInt value;
+	Residue digits;
+	uint32_t inverse;
+
+	/* R^2 mod m and R mod m, the Montgomery forms of R and of one. */
+	Residue rSquared;
+	Residue one;
+
+	/* The words of x's magnitude. */
+	static std::vector<uint32_t> magnitude(const BigInt& x);
+	static BigInt integer(const Residue& x);
+
+	Residue reduced(const BigInt& x) const;
+	Residue toMontgomery(const BigInt& x) const;
+	BigInt fromMontgomery(const Residue& x) const;
+
+	/* r = a * b / R mod m, where r may be a or b, with words() + 2 words of
+	 * scratch.
+	 */
+	void multiply(uint32_t* r, const uint32_t* a, const uint32_t* b, uint32_t* scratch) const;
+
+	Residue straus(const std::vector<Residue>& bases, const std::vector<std::vector<uint32_t>>& exponents,
+		const size_t bits) const;
+	Residue pippenger(const std::vector<Residue>& bases, const std::vector<std::vector<uint32_t>>& exponents,
+		const size_t bits, const size_t digitBits) const;
+};
+
+/* multiPowmod over a context made for the call; modulus must be odd. */
+BigInt multiPowmod(const std::vector<BigInt>& bases, const std::vector<BigInt>& exponents, const BigInt& modulus);
+
+/* Repeated exponentiation of one base, such as a group's generator, by the
+ * comb method (Lim and Lee). An exponent of up to exponentBits bits is
+ * written as teeth rows of spacing = exponentBits / teeth bits, and the
+ * table holds, for every subset of rows, the product of base^(2^(row
+ * spacing)) over them. Each column of the rows is then one lookup, so an
+ * exponentiation takes spacing squarings and as many multiplications,
+ * about a quarter of the work of a sliding window with eight teeth.
+ *
+ * Wider exponents still work, through the context's powmod. The context
+ * must outlive the object.
+ */
+class FixedBasePowmod
+{
+public:
+	FixedBasePowmod(const ModularContext& context, const BigInt& base, const size_t exponentBits);
+
+	const ModularContext& context() const;
+	size_t exponentBits() const;
+
+	/* base^exponent mod m. */
+	BigInt pow(const BigInt& exponent) const;
+
+private:
+	const ModularContext* modular;
+
+	BigInt base;
+	size_t bits;
+	size_t teeth;
+	size_t spacing;
+
+	/* 2^teeth entries of words() words each; entry zero is one. */
+	std::vector<uint32_t> table;
+};
+
+#endif
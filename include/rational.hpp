@@ -0,0 +1,107 @@
+#ifndef INCLUDE_RATIONAL_HPP
+#define INCLUDE_RATIONAL_HPP
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include "bigint.hpp"
+
+/* An exact fraction of BigInts, with a positive denominator.
+ *
+ * Reducing to lowest terms takes a gcd, which costs far more than the
+ * additions and multiplications that make the fraction, so when it happens
+ * is up to BigRational::normalization:
+ *
+ *  - Eager keeps every result in lowest terms, cheaply: sums divide out
+ *    the gcd of the denominators before multiplying up, and products
+ *    cancel across, gcd(a, d) and gcd(c, b) for a/b * c/d, so that only
+ *    factors that could be common are ever looked for.
+ *  - Lazy leaves results as they fall out of the arithmetic, and reduces a
+ *    value only once it is more than growthFactor times the size (in bits)
+ *    it had the last time it was in lowest terms, or when asked for its
+ *    numerator or denominator. Comparisons cross-multiply instead.
+ *
+ * Either way the value is the same, only its representation differs.
+ */
+class BigRational
+{
+public:
+	enum class Normalization { Eager, Lazy };
+
+	static Normalization normalization;
+	static size_t growthFactor;
+
+	BigRational();
+	BigRational(const BigInt& integer);
+
+	/* Throws std::invalid_argument for a zero denominator. */
+	BigRational(const BigInt& numerator, const BigInt& denominator);
+
+	/* "n" or "n/d" in decimal; throws std::invalid_argument otherwise. */
+	explicit BigRational(const std::string& str);
+
+	BigRational(const BigRational& that) = default;
+	BigRational(BigRational&& that) = default;
+
+	BigRational& operator=(const BigRational& that);
+	BigRational& operator=(BigRational&& that) = default;
+
+	/* In lowest terms, without the denominator if it is one. */
+	operator std::string() const;
+
+	friend std::ostream& operator<<(std::ostream& out, const BigRational& value);
+
+	/* In lowest terms, whatever the representation. */
+	BigInt numerator() const;
+	BigInt denominator() const;
+
+	/* Reduce the representation to lowest terms. */
+	void normalize();
+	bool isNormalized() const;
+
+	/* Rounded toward negative infinity, as BigInt division is. */
+	BigInt floor() const;
+
+	bool isZero() const;
+	bool isNegative() const;
+
+	bool operator==(const BigRational& that) const;
+	bool operator!=(const BigRational& that) const;
+	bool operator<(const BigRational& that) const;
+	bool operator>(const BigRational& that) const;
+	bool operator<=(const BigRational& that) const;
+	bool operator>=(const BigRational& that) const;
+
+	BigRational operator-() const;
+
+	BigRational operator+(const BigRational& that) const;
+	BigRational operator-(const BigRational& that) const;
+	BigRational operator*(const BigRational& that) const;
+	BigRational operator/(const BigRational& that) const;
+
+	BigRational& operator+=(const BigRational& that);
+	BigRational& operator-=(const BigRational& that);
+	BigRational& operator*=(const BigRational& that);
+	BigRational& operator/=(const BigRational& that);
+
+private:
+	BigInt top;
+	BigInt bottom;
+
+	bool reduced;
+
+	/* Bits in the numerator and denominator when last in lowest terms. */
+	size_t reference;
+
+	size_t bits() const;
+
+	/* Set the representation to top / bottom, whose signs must already be
+	 * sorted out, and bring it to lowest terms if the policy calls for it.
+	 */
+	void assign(BigInt&& numerator, BigInt&& denominator, const bool lowest, const size_t previous);
+
+	int compare(const BigRational& that) const;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef INCLUDE_RNS_HPP
+#define INCLUDE_RNS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bigint.hpp"
+
+/* A residue number system: integers held as their residues modulo a basis
+ * of primes, so that addition, subtraction and multiplication are
+ * independent word operations on each residue (channel), with no carries
+ * between channels. Long chains of these are cheap; only converting in and
+ * out costs about as much as a multiplication of the full values.
+ */
+class RNSBasis
+{
+public:
+	/* The primes just below 2^31, as many as it takes for their product to
+	 * exceed 2^(bits + 1), so that every integer of up to bits bits of
+	 * either sign has its own residues.
+	 */
+	explicit RNSBasis(const size_t bits);
+
+	size_t size() const;
+	size_t bits() const;
+
+	const std::vector<uint32_t>& moduli() const;
+	const BigInt& product() const;
+
+private:
+	friend class RNSInt;
+
+	/* Channels are reduced from the value through a remainder tree over
+	 * groups of this many primes.
+	 */
+	static const size_t groupSize = 16;
+
+	size_t capacity;
+
+	std::vector<uint32_t> primes;
+	BigInt modulus;
+	std::vector<BigInt> groups;
+
+	/* Montgomery constants for each channel, with R = 2^32: -1 / p mod R,
+	 * R^2 mod p, and for Garner's conversion back, the inverse of the
+	 * product of the earlier primes, in Montgomery form.
+	 */
+	std::vector<uint32_t> inverses;
+	std::vector<uint32_t> rSquared;
+	std::vector<uint32_t> garnerInverses;
+};
+
+/* An integer in a residue number system. Results are exact as long as they
+ * stay within basis().bits() bits; beyond that they wrap modulo the product
+ * of the basis. The basis must outlive its values, and the operands of each
+ * operation must share one.
+ */
+class RNSInt
+{
+public:
+	/* Zero. */
+	explicit RNSInt(const RNSBasis& basis);
+
+	/* Throws std::invalid_argument if value is wider than basis.bits(). */
+	RNSInt(const BigInt& value, const RNSBasis& basis);
+
+	operator BigInt() const;
+
+	const RNSBasis& basis() const;
+
+	/* The residue modulo basis().moduli()[channel]. */
+	uint32_t residue(const size_t channel) const;
+
+	RNSInt operator-() const;
+
+	RNSInt operator+(const RNSInt& that) const;
+	RNSInt operator-(const RNSInt& that) const;
+	RNSInt operator*(const RNSInt& that) const;
+
+	RNSInt& operator+=(const RNSInt& that);
+	RNSInt& operator-=(const RNSInt& that);
+	RNSInt& operator*=(const RNSInt& that);
+
+private:
+	const RNSBasis* system;
+
+	/* In Montgomery form, x R mod p. */
+	std::vector<uint32_t> residues;
+
+	void requireBasis(const RNSInt& that) const;
+};
+
+#endif
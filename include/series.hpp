@@ -0,0 +1,70 @@
+#ifndef INCLUDE_SERIES_HPP
+#define INCLUDE_SERIES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "bigfloat.hpp"
+#include "bigint.hpp"
+
+/* Binary splitting for series whose terms are products of ratios,
+ *
+ *   S = sum over n of a(n) p(0) p(1) ... p(n) / (q(0) q(1) ... q(n)),
+ *
+ * as for e, pi (Chudnovsky), log 2 and zeta(3). The terms [begin, end) are
+ * split in half recursively and combined as
+ *
+ *   P = P_left P_right
+ *   Q = Q_left Q_right
+ *   T = T_left Q_right + P_left T_right,
+ *
+ * where a single term n has P = p(n), Q = q(n) and T = a(n) p(n), so that
+ * the partial sum is T / Q. Every product is of two balanced halves, which
+ * is what lets fast multiplication pay off. p, q and a are called from
+ * several threads at once, so they must be safe to call concurrently.
+ */
+struct Series
+{
+	std::function<BigInt(uint64_t)> p;
+	std::function<BigInt(uint64_t)> q;
+	std::function<BigInt(uint64_t)> a;
+};
+
+struct SplitOptions
+{
+	/* Threads to spread subtrees over; zero for one per core. */
+	unsigned threads = 0;
+
+	/* When not empty, the directory where nodes whose values reach
+	 * spillWords words are kept, and combined with the out-of-core
+	 * arithmetic of outofcore.hpp, instead of in memory. The files are
+	 * unlinked as soon as they are mapped.
+	 */
+	std::string spillDirectory;
+	size_t spillWords = size_t(1) << 22;
+};
+
+struct SeriesSplit
+{
+	BigInt P;
+	BigInt Q;
+	BigInt T;
+};
+
+/* P, Q and T over the terms [begin, end), which must not be empty. P is
+ * only needed to extend the range to the right; without wantP it is left
+ * zero, which saves a product at every node down the right-hand side.
+ */
+SeriesSplit splitSeries(const Series& series, const uint64_t begin, const uint64_t end,
+	const SplitOptions& options = SplitOptions(), const bool wantP = false);
+
+/* The sum of the first terms terms, T / Q rounded to precision bits. As T
+ * and Q are each rounded first, the result is within a unit or two in the
+ * last place of the partial sum.
+ */
+BigFloat sumSeries(const Series& series, const uint64_t terms, const size_t precision,
+	const SplitOptions& options = SplitOptions());
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef INCLUDE_SHAREDWORDS_HPP
+#define INCLUDE_SHAREDWORDS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+/* The words of a BigInt, shared copy-on-write between copies.
+ *
+ * Copying takes another reference to the same block rather than copying the
+ * words, so even huge values can be passed and kept by value. The block is
+ * copied the first time a copy that shares it is written to, which is any use
+ * of a non-const member: the non-const data(), operator[], iterators, and
+ * everything that grows the words. Const access never copies, and neither
+ * does shrinking, which only moves this copy's end.
+ *
+ * The reference count is atomic, so copies sharing a block may be read and
+ * destroyed from different threads; each SharedWords object itself still
+ * needs the same synchronisation as a std::vector. Pointers and references
+ * from the non-const members must not be written through after the words
+ * have been copied again, since the copy would see the writes.
+ *
+ * A block may also borrow words that live elsewhere, such as in a read-only
+ * mapping (see borrow()). Such a block is never written to: the first write
+ * through any copy, even the only one, copies the words first, as if the
+ * block were shared.
+ *
+ * The interface is the part of std::vector<uint32_t> that BigInt uses.
+ */
+class SharedWords
+{
+public:
+	typedef uint32_t value_type;
+	typedef uint32_t* iterator;
+	typedef const uint32_t* const_iterator;
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+	SharedWords();
+	explicit SharedWords(const size_t count, const uint32_t value = 0);
+	SharedWords(const uint32_t* first, const uint32_t* last);
+	SharedWords(const SharedWords& that);
+	SharedWords(SharedWords&& that);
+	~SharedWords();
+
+	SharedWords& operator=(const SharedWords& that);
+	SharedWords& operator=(SharedWords&& that);
+
+	/* count words at words, which are not copied. The last copy to let go
+	 * of them calls dispose(owner, ownerLength), which must keep the words
+	 * valid and unchanged until then.
+	 */
+	static SharedWords borrow(const uint32_t* words, const size_t count, void* owner, const size_t ownerLength,
+		void (*dispose)(void*, size_t));
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	/* Zero for borrowed words, which have no room to be written. */
+	size_t capacity() const { return block == nullptr ? 0 : block->capacity; }
+
+	/* Whether another copy holds the same block. */
+	bool shared() const;
+
+	const uint32_t* data() const { return block == nullptr ? nullptr : block->words(); }
+	uint32_t* data() { unshare(); return block == nullptr ? nullptr : block->words(); }
+
+	const uint32_t& operator[](const size_t i) const { return block->words()[i]; }
+	uint32_t& operator[](const size_t i) { unshare(); return block->words()[i]; }
+
+	const uint32_t& front() const { return (*this)[0]; }
+	uint32_t& front() { return (*this)[0]; }
+	const uint32_t& back() const { return (*this)[count - 1]; }
+	uint32_t& back() { return (*this)[count - 1]; }
+
+	const_iterator begin() const { return data(); }
+	const_iterator end() const { return data() + count; }
+	iterator begin() { return data(); }
+	iterator end() { return data() + count; }
+	const_iterator cbegin() const { return begin(); }
+	const_iterator cend() const { return end(); }
+
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+	const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+	reverse_iterator rbegin() { return reverse_iterator(end()); }
+	reverse_iterator rend() { return reverse_iterator(begin()); }
+	const_reverse_iterator crbegin() const { return rbegin(); }
+	const_reverse_iterator crend() const { return rend(); }
+
+	void reserve(const size_t capacity);
+	void shrink_to_fit();
+	/* Growing past the capacity makes room for exactly size words. */
+	void resize(const size_t size, const uint32_t value = 0);
+	void assign(const size_t size, const uint32_t value);
+
+	void push_back(const uint32_t word)
+	{
+		if (block == nullptr || count >= block->capacity || block->references.load(std::memory_order_acquire) != 1)
+			grow(count + 1);
+
+		block->words()[count++] = word;
+	}
+
+	void pop_back() { count--; }
+
+private:
+	/* The words follow the header in the same allocation, unless they are
+	 * borrowed, when the capacity is zero and dispose lets go of them.
+	 */
+	struct Block
+	{
+		explicit Block(size_t capacity)
+			: references(1), capacity(capacity), start(reinterpret_cast<uint32_t*>(this + 1)),
+			  owner(nullptr), ownerLength(0), dispose(nullptr)
+		{
+		}
+
+		uint32_t* words() { return start; }
+
+		std::atomic<size_t> references;
+		size_t capacity;
+		uint32_t* start;
+
+		void* owner;
+		size_t ownerLength;
+		void (*dispose)(void*, size_t);
+	};
+
+	Block* block;
+	size_t count;
+
+	static Block* allocate(const size_t capacity);
+	static void release(Block* block);
+
+	void unshare()
+	{
+		if (block != nullptr && (count > block->capacity || block->references.load(std::memory_order_acquire) != 1))
+			reallocate(count);
+	}
+
+	/* Make the block this copy's own with room for size words, growing
+	 * geometrically like std::vector. A borrowed block has no capacity, so it
+	 * is always copied.
+	 */
+	void grow(const size_t size);
+
+	/* Move the words into a new block of their own with the given capacity. */
+	void reallocate(const size_t capacity);
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef INCLUDE_TREE_HPP
+#define INCLUDE_TREE_HPP
+
+#include <cstddef>
+#include <thread>
+
+/* What the divide and conquer code in src/ shares, private to it: when a
+ * split is worth a thread, how many threads to start from, and where
+ * productTree() puts a node's children.
+ */
+
+/* Subtrees with fewer leaves than this are not worth a thread. */
+const size_t parallelCutoff = 64;
+
+inline unsigned defaultThreads()
+{
+	unsigned threads = std::thread::hardware_concurrency();
+	return threads == 0 ? 1 : threads;
+}
+
+/* The product tree is stored in preorder: the node covering [begin, end)
+ * lives at index node, its left child at node + 1 and its right child
+ * after the 2 * (mid - begin) - 1 nodes of the left subtree.
+ */
+inline size_t rightChild(const size_t node, const size_t begin, const size_t mid)
+{
+	return node + 2 * (mid - begin);
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef INCLUDE_TUNING_HPP
+#define INCLUDE_TUNING_HPP
+
+/* Cutover points between the algorithms used for each operation.
+ *
+ * `make tune` times the competing algorithms on the host and writes the
+ * crossovers it finds to tuned.hpp, which takes precedence over the
+ * defaults below.
+ */
+#if defined(__has_include)
+#if __has_include("tuned.hpp")
+#include "tuned.hpp"
+#endif
+#endif
+
+/* Operands of at least this many words are multiplied with Karatsuba. */
+#ifndef KARATSUBA_THRESHOLD
+#define KARATSUBA_THRESHOLD 32
+#endif
+
+/* Decimal strings of at least this many digits are parsed by splitting. */
+#ifndef PARSE_THRESHOLD
+#define PARSE_THRESHOLD 800
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+#include "accumulator.hpp"
+
+namespace
+{
+	const int64_t base = int64_t(1) << 32;
+
+	template <bool Negative>
+	void addWords(int64_t* lanes, const uint32_t* words, const size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			lanes[i] += Negative ? -static_cast<int64_t>(words[i]) : static_cast<int64_t>(words[i]);
+	}
+
+	/* lanes[0..count] += words * factor, for count > 0. Lane i takes the
+	 * low half of word i's product and the high half of word i - 1's, so
+	 * each lane is written once and no iteration depends on another.
+	 */
+	template <bool Negative>
+	void addProducts(int64_t* lanes, const uint32_t* words, const size_t count, const uint64_t factor)
+	{
+		int64_t first = static_cast<uint32_t>(words[0] * factor);
+		lanes[0] += Negative ? -first : first;
+
+		for (size_t i = 1; i < count; i++)
+		{
+			int64_t term = static_cast<int64_t>(static_cast<uint32_t>(words[i] * factor)
+				+ ((words[i - 1] * factor) >> 32));
+
+			lanes[i] += Negative ? -term : term;
+		}
+
+		int64_t last = static_cast<int64_t>((words[count - 1] * factor) >> 32);
+		lanes[count] += Negative ? -last : last;
+	}
+}
+
+BigIntAccumulator::BigIntAccumulator() : pending(0)
+{
+}
+
+void BigIntAccumulator::add(const BigInt& value)
+{
+	accumulate(value, !value.positive);
+}
+
+void BigIntAccumulator::sub(const BigInt& value)
+{
+	accumulate(value, value.positive);
+}
+
+void BigIntAccumulator::addmul(const BigInt& value, const uint32_t factor)
+{
+	const BigInt::Words& words = value.words;
+	int64_t* lane = prepare(words.size() + 1);
+
+	if (value.positive)
+		addProducts<false>(lane, words.data(), words.size(), factor);
+	else
+		addProducts<true>(lane, words.data(), words.size(), factor);
+}
+
+BigInt BigIntAccumulator::result() const
+{
+	if (lanes.empty())
+		return BigInt();
+
+	BigInt::Words words;
+	words.reserve(lanes.size());
+
+	int64_t carry = 0;
+
+	for (auto lane : lanes)
+	{
+		int64_t sum = lane + carry;
+
+		words.push_back(static_cast<uint32_t>(sum));
+		carry = sum >> 32;
+	}
+
+	BigInt sum(std::move(words));
+	sum.trim();
+
+	/* Whatever carried out of the top lane, including a borrow for a
+	 * negative sum, is worth carry * 2^(32 lanes).
+	 */
+	if (carry != 0)
+	{
+		BigInt high;
+		high += carry;
+		high <<= static_cast<uint32_t>(32 * lanes.size());
+		sum += high;
+	}
+
+	return sum;
+}
+
+void BigIntAccumulator::accumulate(const BigInt& value, const bool negative)
+{
+	const BigInt::Words& words = value.words;
+	int64_t* lane = prepare(words.size());
+
+	if (negative)
+		addWords<true>(lane, words.data(), words.size());
+	else
+		addWords<false>(lane, words.data(), words.size());
+}
+
+int64_t* BigIntAccumulator::prepare(const size_t count)
+{
+	if (pending == maxPending)
+		normalize();
+
+	if (lanes.size() < count)
+		lanes.resize(count, 0);
+
+	pending++;
+
+	return lanes.data();
+}
+
+void BigIntAccumulator::normalize()
+{
+	int64_t carry = 0;
+
+	for (auto& lane : lanes)
+	{
+		int64_t sum = lane + carry;
+
+		lane = sum & (base - 1);
+		carry = sum >> 32;
+	}
+
+	while (carry != 0 && carry != -1)
+	{
+		lanes.push_back(carry & (base - 1));
+		carry >>= 32;
+	}
+
+	/* A final borrow stays in the top lane as its sign. */
+	if (carry == -1)
+		lanes.back() -= base;
+
+	pending = 0;
+}
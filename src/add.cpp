@@ -1,15 +1,17 @@
+#include <algorithm>
+
 #include "bigint.hpp"
 
 BigInt BigInt::operator++()
 {
 	BigInt old(*this);
-	*this += one;
+	addScalar(false, 1);
 	return old;
 }
 
 BigInt& BigInt::operator++(const int)
 {
-	*this += one;
+	addScalar(false, 1);
 	return *this;
 }
 
@@ -23,7 +25,24 @@ BigInt BigInt::operator+(const BigInt& that) const
 BigInt& BigInt::operator+=(const BigInt& that)
 {
 	if (positive && !that.positive)
-		return *this -= that.words;
+	{
+		/* Comparing -|this| with that tells us which magnitude is larger. */
+		positive = false;
+
+		if (*this <= that)
+		{
+			*this -= that.words;
+			positive = true;
+		}
+		else
+		{
+			BigInt copy(that);
+			copy -= words;
+			*this = std::move(copy);
+		}
+
+		return *this;
+	}
 	else if (!positive && that.positive)
 	{
 		positive = true;
@@ -31,7 +50,7 @@ BigInt& BigInt::operator+=(const BigInt& that)
 		if (*this >= that)
 		{
 			*this -= that.words;
-			positive = false;
+			positive = isZero();
 		}
 		else
 		{
@@ -48,36 +67,149 @@ BigInt& BigInt::operator+=(const BigInt& that)
 
 BigInt& BigInt::operator+=(const BigInt::Words& that)
 {
-	bool thisSmaller = words.size() < that.size();
+	const size_t smaller = std::min(words.size(), that.size());
+	const size_t larger = std::max(words.size(), that.size());
+	const bool thisSmaller = words.size() < that.size();
 
-	const BigInt::Words& larger = thisSmaller ? that : words;
-	const BigInt::Words& smaller = thisSmaller ? words : that;
+	words.resize(larger, 0);
+
+	/* The words are this copy's own from here on, so the loops can work
+	 * through plain pointers. that may be words itself, so it is read after.
+	 */
+	uint32_t* sum = words.data();
+	const uint32_t* addend = that.data();
+	const uint32_t* rest = thisSmaller ? addend : sum;
 
 	uint32_t carry = 0;
 
-	for (size_t i = 0; i < larger.size(); i++)
+	for (size_t i = 0; i < smaller; i++)
+	{
+		uint64_t word = static_cast<uint64_t>(carry) + static_cast<uint64_t>(sum[i]) + static_cast<uint64_t>(addend[i]);
+
+		sum[i] = static_cast<uint32_t>(word);
+		carry = word >> 32;
+	}
+
+	for (size_t i = smaller; i < larger; i++)
+	{
+		uint64_t word = static_cast<uint64_t>(carry) + static_cast<uint64_t>(rest[i]);
+
+		sum[i] = static_cast<uint32_t>(word);
+		carry = word >> 32;
+	}
+
+	if (carry != 0)
+		words.resize(words.size() + 1, carry);
+
+	return *this;
+}
+
+BigInt BigInt::operator+(const int that) const
+{
+	BigInt copy(*this);
+	copy += that;
+	return copy;
+}
+
+BigInt BigInt::operator+(const uint32_t that) const
+{
+	BigInt copy(*this);
+	copy += that;
+	return copy;
+}
+
+BigInt BigInt::operator+(const int64_t that) const
+{
+	BigInt copy(*this);
+	copy += that;
+	return copy;
+}
+
+BigInt BigInt::operator+(const uint64_t that) const
+{
+	BigInt copy(*this);
+	copy += that;
+	return copy;
+}
+
+BigInt& BigInt::operator+=(const int that)
+{
+	return *this += static_cast<int64_t>(that);
+}
+
+BigInt& BigInt::operator+=(const uint32_t that)
+{
+	return addScalar(false, that);
+}
+
+BigInt& BigInt::operator+=(const int64_t that)
+{
+	return addScalar(that < 0, magnitudeOf(that));
+}
+
+BigInt& BigInt::operator+=(const uint64_t that)
+{
+	return addScalar(false, that);
+}
+
+BigInt& BigInt::addScalar(const bool negative, const uint64_t magnitude)
+{
+	if (magnitude == 0)
+		return *this;
+
+	if (isZero())
 	{
-		uint64_t sum;
-		if (i < smaller.size())
+		assignScalar(negative, magnitude);
+		return *this;
+	}
+
+	if (positive != negative)
+	{
+		/* The signs agree, so add to the magnitude in place. The carry is
+		 * split so that it never overflows.
+		 */
+		uint64_t carry = magnitude;
+
+		for (size_t i = 0; carry != 0; i++)
 		{
-			sum = static_cast<uint64_t>(carry) + static_cast<uint64_t>(words[i]) + static_cast<uint64_t>(that[i]);
+			if (i == words.size())
+				words.resize(i + (carry >> 32 != 0 ? 2 : 1), 0);
+
+			uint64_t sum = static_cast<uint64_t>(words[i]) + (carry & 0xFFFFFFFF);
 
 			words[i] = static_cast<uint32_t>(sum);
+			carry = (carry >> 32) + (sum >> 32);
 		}
-		else
-		{
-			sum = static_cast<uint64_t>(carry) + static_cast<uint64_t>(larger[i]);
 
-			if (thisSmaller)
-				words.push_back(static_cast<uint32_t>(sum));
-			else
-				words[i] = static_cast<uint32_t>(sum);
+		return *this;
+	}
+
+	if (words.size() <= 2)
+	{
+		uint64_t value = words[0] | (words.size() == 2 ? static_cast<uint64_t>(words[1]) << 32 : 0);
+
+		/* The scalar's magnitude is the larger one, so it decides the sign. */
+		if (value < magnitude)
+		{
+			assignScalar(negative, magnitude - value);
+			return *this;
 		}
-		carry = sum >> 32;
 	}
 
-	if (carry != 0)
-		words.push_back(carry);
+	uint64_t borrow = magnitude;
+
+	for (size_t i = 0; borrow != 0; i++)
+	{
+		uint64_t word = words[i], low = borrow & 0xFFFFFFFF;
+
+		words[i] = static_cast<uint32_t>(word - low);
+		borrow = (borrow >> 32) + (word < low);
+	}
+
+	trim();
+
+	if (isZero())
+		positive = true;
 
 	return *this;
 }
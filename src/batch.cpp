@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "batch.hpp"
+#include "batchkernels.hpp"
+
+namespace
+{
+	/* One lane in a plain 64 bit integer, for any CPU. */
+	struct ScalarLanes
+	{
+		typedef uint64_t Vector;
+
+		static const size_t lanes = 1;
+
+		static Vector load(const uint32_t* p) { return *p; }
+		static void store(uint32_t* p, Vector v) { *p = static_cast<uint32_t>(v); }
+		static Vector broadcast(uint64_t x) { return x; }
+		static Vector add(Vector a, Vector b) { return a + b; }
+		static Vector sub(Vector a, Vector b) { return a - b; }
+		static Vector mul(Vector a, Vector b) { return (a & 0xFFFFFFFFu) * (b & 0xFFFFFFFFu); }
+		static Vector low(Vector a) { return a & 0xFFFFFFFFu; }
+		static Vector high(Vector a) { return a >> 32; }
+		static Vector select(Vector condition, Vector ifSet, Vector ifClear) { return condition != 0 ? ifSet : ifClear; }
+	};
+
+	BigIntBatch::Kernel best()
+	{
+		if (BigIntBatch::supported(BigIntBatch::Kernel::AVX512))
+			return BigIntBatch::Kernel::AVX512;
+
+		if (BigIntBatch::supported(BigIntBatch::Kernel::AVX2))
+			return BigIntBatch::Kernel::AVX2;
+
+		return BigIntBatch::Kernel::Scalar;
+	}
+
+	const BatchKernels& selected()
+	{
+		if (!BigIntBatch::supported(BigIntBatch::kernel))
+			throw std::runtime_error("the selected batch kernel is not supported by this CPU");
+
+		switch (BigIntBatch::kernel)
+		{
+		case BigIntBatch::Kernel::AVX512:
+			return *avx512BatchKernels;
+		case BigIntBatch::Kernel::AVX2:
+			return *avx2BatchKernels;
+		default:
+			return scalarBatchKernels;
+		}
+	}
+}
+
+const BatchKernels scalarBatchKernels = { batchAdd<ScalarLanes>, batchSubtract<ScalarLanes>,
+	batchMultiply<ScalarLanes>, batchMontgomery<ScalarLanes> };
+
+BigIntBatch::Kernel BigIntBatch::kernel = best();
+
+bool BigIntBatch::supported(const Kernel kernel)
+{
+#ifdef __x86_64__
+	/* This may run before main, ahead of the CPU model's own initialisation. */
+	__builtin_cpu_init();
+
+	switch (kernel)
+	{
+	case Kernel::AVX512:
+		return avx512BatchKernels != nullptr && __builtin_cpu_supports("avx512f");
+	case Kernel::AVX2:
+		return avx2BatchKernels != nullptr && __builtin_cpu_supports("avx2");
+	default:
+		return true;
+	}
+#else
+	return kernel == Kernel::Scalar;
+#endif
+}
+
+BigIntBatch::BigIntBatch(const size_t count, const size_t words)
+	: count(count), stride((count + lanes - 1) / lanes * lanes), width(words)
+{
+	if (words == 0)
+		throw std::invalid_argument("batch values must be at least one word wide");
+
+	limbs.resize(stride * width, 0);
+}
+
+BigIntBatch::BigIntBatch(const std::vector<BigInt>& values, const size_t words)
+	: BigIntBatch(values.size(), words)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		const BigInt& value = values[i];
+
+		if (value.isNegative() || value.size() > 32 * width)
+			throw std::invalid_argument("value does not fit the batch");
+
+		for (size_t j = 0; j < value.words.size() && j < width; j++)
+			limbs[j * stride + i] = value.words[j];
+	}
+}
+
+BigIntBatch::operator std::vector<BigInt>() const
+{
+	std::vector<BigInt> values;
+	values.reserve(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		BigInt::Words words(width);
+
+		for (size_t j = 0; j < width; j++)
+			words[j] = limbs[j * stride + i];
+
+		BigInt value(std::move(words));
+		value.trim();
+		values.push_back(std::move(value));
+	}
+
+	return values;
+}
+
+size_t BigIntBatch::size() const
+{
+	return count;
+}
+
+size_t BigIntBatch::words() const
+{
+	return width;
+}
+
+BigIntBatch BigIntBatch::operator+(const BigIntBatch& that) const
+{
+	BigIntBatch copy(*this);
+	copy += that;
+	return copy;
+}
+
+BigIntBatch BigIntBatch::operator-(const BigIntBatch& that) const
+{
+	BigIntBatch copy(*this);
+	copy -= that;
+	return copy;
+}
+
+BigIntBatch& BigIntBatch::operator+=(const BigIntBatch& that)
+{
+	requireShape(that, true);
+	selected().add(limbs.data(), limbs.data(), that.limbs.data(), width, stride);
+
+	return *this;
+}
+
+BigIntBatch& BigIntBatch::operator-=(const BigIntBatch& that)
+{
+	requireShape(that, true);
+	selected().subtract(limbs.data(), limbs.data(), that.limbs.data(), width, stride);
+
+	return *this;
+}
+
+BigIntBatch BigIntBatch::operator*(const BigIntBatch& that) const
+{
+	requireShape(that, false);
+
+	BigIntBatch product(count, width + that.width);
+	selected().multiply(product.limbs.data(), limbs.data(), width, that.limbs.data(), that.width, stride);
+
+	return product;
+}
+
+void BigIntBatch::requireShape(const BigIntBatch& that, const bool sameWidth) const
+{
+	if (count != that.count || (sameWidth && width != that.width))
+		throw std::invalid_argument("batches differ in shape");
+}
+
+BigIntBatch BigIntBatch::filled(const size_t count, const BigInt& value, const size_t words)
+{
+	BigIntBatch batch(count, words);
+
+	for (size_t j = 0; j < value.words.size() && j < words; j++)
+		std::fill(batch.limbs.begin() + j * batch.stride, batch.limbs.begin() + j * batch.stride + count,
+			value.words[j]);
+
+	return batch;
+}
+
+BatchMontgomery::BatchMontgomery(const BigInt& modulus)
+{
+	if (modulus <= 1u || !modulus.testBit(0))
+		throw std::invalid_argument("the modulus must be odd and greater than one");
+
+	const BigInt::Words& words = modulus.words;
+	this->modulus.assign(words.begin(), words.end());
+
+	/* Newton's iteration doubles the correct low bits of 1 / m each time,
+	 * and m is its own inverse to three bits.
+	 */
+	uint32_t x = words[0];
+	for (size_t i = 0; i < 4; i++)
+		x *= 2 - words[0] * x;
+
+	inverse = -x;
+	rSquared = (BigInt(1) << static_cast<uint32_t>(64 * words.size())) % modulus;
+}
+
+size_t BatchMontgomery::words() const
+{
+	return modulus.size();
+}
+
+BigIntBatch BatchMontgomery::mulmod(const BigIntBatch& a, const BigIntBatch& b) const
+{
+	return multiply(multiply(a, b), BigIntBatch::filled(a.count, rSquared, words()));
+}
+
+BigIntBatch BatchMontgomery::multiply(const BigIntBatch& a, const BigIntBatch& b) const
+{
+	if (a.width != words())
+		throw std::invalid_argument("batch values must be as wide as the modulus");
+
+	a.requireShape(b, true);
+
+	BigIntBatch product(a.count, words());
+	std::vector<uint32_t> scratch((words() + 2) * BigIntBatch::lanes);
+
+	selected().montgomery(product.limbs.data(), a.limbs.data(), b.limbs.data(), modulus.data(), inverse,
+		words(), a.stride, scratch.data());
+
+	return product;
+}
+
+BigIntBatch BatchMontgomery::toMontgomery(const BigIntBatch& a) const
+{
+	return multiply(a, BigIntBatch::filled(a.count, rSquared, words()));
+}
+
+BigIntBatch BatchMontgomery::fromMontgomery(const BigIntBatch& a) const
+{
+	return multiply(a, BigIntBatch::filled(a.count, BigInt(1), words()));
+}
@@ -0,0 +1,70 @@
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+
+/* Only this file is built for AVX2, so the rest of the library still runs on
+ * machines without it; BigIntBatch checks for AVX2 before using these.
+ */
+#ifdef __clang__
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include "batchkernels.hpp"
+
+namespace
+{
+	struct AVX2Lanes
+	{
+		typedef __m256i Vector;
+
+		static const size_t lanes = 4;
+
+		static Vector load(const uint32_t* p)
+		{
+			return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+		}
+
+		static void store(uint32_t* p, Vector v)
+		{
+			Vector packed = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_castsi256_si128(packed));
+		}
+
+		static Vector broadcast(uint64_t x) { return _mm256_set1_epi64x(static_cast<long long>(x)); }
+		static Vector add(Vector a, Vector b) { return _mm256_add_epi64(a, b); }
+		static Vector sub(Vector a, Vector b) { return _mm256_sub_epi64(a, b); }
+		static Vector mul(Vector a, Vector b) { return _mm256_mul_epu32(a, b); }
+		static Vector low(Vector a) { return _mm256_and_si256(a, broadcast(0xFFFFFFFFu)); }
+		static Vector high(Vector a) { return _mm256_srli_epi64(a, 32); }
+
+		static Vector select(Vector condition, Vector ifSet, Vector ifClear)
+		{
+			Vector clear = _mm256_cmpeq_epi64(condition, _mm256_setzero_si256());
+
+			return _mm256_blendv_epi8(ifSet, ifClear, clear);
+		}
+	};
+}
+
+#ifdef __clang__
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+namespace
+{
+	/* Constant initialised, so nothing built for AVX2 runs at startup. */
+	const BatchKernels kernels = { batchAdd<AVX2Lanes>, batchSubtract<AVX2Lanes>,
+		batchMultiply<AVX2Lanes>, batchMontgomery<AVX2Lanes> };
+}
+
+const BatchKernels* const avx2BatchKernels = &kernels;
+#else
+#include "batchkernels.hpp"
+
+const BatchKernels* const avx2BatchKernels = nullptr;
+#endif
@@ -0,0 +1,77 @@
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+
+/* Only this file is built for AVX-512, so the rest of the library still runs
+ * on machines without it; BigIntBatch checks for AVX-512F before using these.
+ */
+#ifdef __clang__
+#pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+
+/* GCC 12's own AVX-512 headers trip this by initialising their undefined
+ * vectors from themselves, once inlined into the kernels below. push_options
+ * doesn't save diagnostics, so they have their own push.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include "batchkernels.hpp"
+
+namespace
+{
+	struct AVX512Lanes
+	{
+		typedef __m512i Vector;
+
+		static const size_t lanes = 8;
+
+		static Vector load(const uint32_t* p)
+		{
+			return _mm512_cvtepu32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+		}
+
+		static void store(uint32_t* p, Vector v)
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm512_cvtepi64_epi32(v));
+		}
+
+		static Vector broadcast(uint64_t x) { return _mm512_set1_epi64(static_cast<long long>(x)); }
+		static Vector add(Vector a, Vector b) { return _mm512_add_epi64(a, b); }
+		static Vector sub(Vector a, Vector b) { return _mm512_sub_epi64(a, b); }
+		static Vector mul(Vector a, Vector b) { return _mm512_mul_epu32(a, b); }
+		static Vector low(Vector a) { return _mm512_and_si512(a, broadcast(0xFFFFFFFFu)); }
+		static Vector high(Vector a) { return _mm512_srli_epi64(a, 32); }
+
+		static Vector select(Vector condition, Vector ifSet, Vector ifClear)
+		{
+			return _mm512_mask_blend_epi64(_mm512_test_epi64_mask(condition, condition), ifClear, ifSet);
+		}
+	};
+}
+
+#ifdef __clang__
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+namespace
+{
+	/* Constant initialised, so nothing built for AVX-512 runs at startup. */
+	const BatchKernels kernels = { batchAdd<AVX512Lanes>, batchSubtract<AVX512Lanes>,
+		batchMultiply<AVX512Lanes>, batchMontgomery<AVX512Lanes> };
+}
+
+#ifndef __clang__
+#pragma GCC diagnostic pop
+#endif
+
+const BatchKernels* const avx512BatchKernels = &kernels;
+#else
+#include "batchkernels.hpp"
+
+const BatchKernels* const avx512BatchKernels = nullptr;
+#endif
@@ -0,0 +1,332 @@
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "accumulator.hpp"
+#include "batch.hpp"
+#include "bigfloat.hpp"
+#include "bigint.hpp"
+#include "crt.hpp"
+#include "powmod.hpp"
+#include "rational.hpp"
+#include "rns.hpp"
+#include "series.hpp"
+
+using namespace std;
+
+/* Usage: bench.exe [max words] [min seconds per measurement]
+ *
+ * Every operation is timed at operand sizes of 1, 2, 4, ... words up to the
+ * maximum. Once a single call to an operation, or building its operands,
+ * takes longer than the cutoff, larger sizes of that operation are skipped.
+ * The results are written to stdout as JSON.
+ */
+
+namespace
+{
+	const double cutoffSeconds = 2.0;
+
+	mt19937 generator(42);
+
+	/* Build a random value of exactly count words. Building the halves and
+	 * joining them keeps this fast even for a million words.
+	 */
+	BigInt randomWords(size_t count)
+	{
+		if (count == 1)
+		{
+			uint32_t word = generator();
+			return BigInt(word == 0 ? 1 : word);
+		}
+
+		size_t low = count / 2;
+		BigInt high(randomWords(count - low));
+		high <<= static_cast<uint32_t>(32 * low);
+
+		return high + randomWords(low);
+	}
+
+	/* The count largest primes below 2^31, sieved down from there a block at
+	 * a time by the primes below its square root.
+	 */
+	vector<uint32_t> largePrimes(size_t count)
+	{
+		const uint32_t top = 0x80000000u, block = 1 << 20;
+		vector<uint32_t> small, primes;
+		vector<bool> composite(46341);
+
+		for (uint32_t i = 2; i < composite.size(); i++)
+			if (!composite[i])
+			{
+				small.push_back(i);
+				for (uint32_t j = i * i; j < composite.size(); j += i)
+					composite[j] = true;
+			}
+
+		for (uint32_t high = top; primes.size() < count; high -= block)
+		{
+			const uint32_t low = high - block;
+			vector<bool> sieve(block);
+
+			for (uint32_t p : small)
+				for (uint32_t j = (low + p - 1) / p * p; j < high; j += p)
+					sieve[j - low] = true;
+
+			for (uint32_t i = high; i > low && primes.size() < count; i--)
+				if (!sieve[i - 1 - low])
+					primes.push_back(i - 1);
+		}
+
+		return primes;
+	}
+
+	/* maxWords caps the sizes tried, where it isn't zero. */
+	struct Benchmark
+	{
+		Benchmark(const string& name, const function<function<void()>(size_t)>& setup, size_t maxWords = 0)
+			: name(name), setup(setup), maxWords(maxWords)
+		{
+		}
+
+		string name;
+		function<function<void()>(size_t)> setup;
+		size_t maxWords;
+	};
+
+	struct Result
+	{
+		string name;
+		size_t words;
+		size_t iterations;
+		double nanoseconds;
+	};
+
+	double seconds(chrono::steady_clock::time_point start)
+	{
+		return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	}
+
+	Result measure(const string& name, size_t words, const function<void()>& run, double minSeconds)
+	{
+		size_t iterations = 0;
+		auto start = chrono::steady_clock::now();
+
+		do
+		{
+			run();
+			iterations++;
+		}
+		while (seconds(start) < minSeconds);
+
+		return Result { name, words, iterations, seconds(start) * 1e9 / iterations };
+	}
+
+	volatile size_t sink;
+}
+
+int main(int argc, char** argv)
+{
+	size_t maxWords = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1024;
+	double minSeconds = argc > 2 ? strtod(argv[2], nullptr) : 0.1;
+
+	if (maxWords == 0)
+	{
+		cerr << "the maximum size must be at least one word" << endl;
+		return 1;
+	}
+
+	vector<Benchmark> benchmarks {
+		{"copy", [](size_t n) {
+			BigInt a(randomWords(n));
+			return [=]() { BigInt copy(a); sink = copy.size(); };
+		}},
+		{"add", [](size_t n) {
+			BigInt a(randomWords(n)), b(randomWords(n));
+			return [=]() { sink = (a + b).size(); };
+		}},
+		{"accumulate", [](size_t n) {
+			BigInt a(randomWords(n));
+			auto sum = make_shared<BigIntAccumulator>();
+			return [=]() { sum->add(a); };
+		}},
+		{"sub", [](size_t n) {
+			BigInt a(randomWords(n)), b(randomWords(n));
+			return [=]() { sink = (a - b).size(); };
+		}},
+		{"mul", [](size_t n) {
+			BigInt a(randomWords(n)), b(randomWords(n));
+			return [=]() { sink = (a * b).size(); };
+		}},
+		{"mul_word", [](size_t n) {
+			BigInt a(randomWords(n));
+			return [=]() { sink = (a * 0x9E3779B9u).size(); };
+		}},
+		{"div", [](size_t n) {
+			BigInt a(randomWords(2 * n)), b(randomWords(n));
+			return [=]() { sink = (a / b).size(); };
+		}},
+		{"div_word", [](size_t n) {
+			BigInt a(randomWords(n));
+			return [=]() { sink = (a / 0x9E3779B9u).size(); };
+		}},
+		{"divexact", [](size_t n) {
+			BigInt b(randomWords(n)), a(randomWords(n) * b);
+			return [=]() { sink = a.divexact(b).size(); };
+		}},
+		{"batch_mulmod", [](size_t n) {
+			/* Each call is 64 modular products, one per lane. */
+			BigInt m(randomWords(n));
+			m.setBit(0);
+			m.setBit(32 * n - 1);
+
+			BatchMontgomery montgomery(m);
+			vector<BigInt> values;
+			for (size_t i = 0; i < 64; i++)
+				values.push_back(randomWords(n) % m);
+
+			BigIntBatch x(values, montgomery.words());
+			return [=]() { sink = montgomery.mulmod(x, x).size(); };
+		}},
+		{"rns_mul", [](size_t n) {
+			/* Room for the product of two n word values. Building the basis
+			 * is quadratic in its size, so the sizes stop well short of the
+			 * others. The values point at the basis, so the run keeps it.
+			 */
+			auto basis = make_shared<RNSBasis>(64 * n + 1);
+			RNSInt a(randomWords(n), *basis), b(randomWords(n), *basis);
+			return [basis, a, b]() { sink = (a * b).residue(0); };
+		}, 4096},
+		{"float_sqrt", [](size_t n) {
+			BigFloat x(BigInt(randomWords(n)) + 1u, 32 * n);
+			return [=]() { sink = sqrt(x).exponent(); };
+		}},
+		{"gcd", [](size_t n) {
+			BigInt a(randomWords(n)), b(randomWords(n));
+			return [=]() { sink = gcd(a, b).size(); };
+		}},
+		{"rational_add", [](size_t n) {
+			BigRational a(randomWords(n), randomWords(n) + 1u), b(randomWords(n), randomWords(n) + 1u);
+			return [=]() { sink = (a + b).isNegative(); };
+		}},
+		{"series", [](size_t n) {
+			/* Terms of e, about n words of result per 12 terms. */
+			auto e = make_shared<Series>();
+			e->p = [](uint64_t) { return BigInt(1); };
+			e->q = [](uint64_t k) { return BigInt(k == 0 ? 1 : static_cast<uint32_t>(k)); };
+			e->a = [](uint64_t) { return BigInt(1); };
+			return [=]() { sink = splitSeries(*e, 0, 12 * n).Q.size(); };
+		}},
+		{"residues", [](size_t n) {
+			/* An n word value by 256 word-sized moduli in one pass. */
+			BigInt x(randomWords(n));
+			vector<uint32_t> moduli(RNSBasis(256 * 31 - 40).moduli());
+			return [=]() { sink = residues(x, moduli)[0]; };
+		}},
+		{"crt", [](size_t n) {
+			/* Back from the residues of an n word value, by primes over 2^30. */
+			auto context = make_shared<CRTContext>(largePrimes(32 * n / 30 + 1));
+			vector<uint32_t> remainders(context->reduce(BigInt(randomWords(n))));
+			return [=]() { sink = context->combine(remainders).size(); };
+		}},
+		{"powmod", [](size_t n) {
+			auto context = make_shared<ModularContext>(BigInt(randomWords(n)) | 1u);
+			BigInt base(randomWords(n)), exponent(randomWords(n));
+			return [=]() { sink = context->powmod(base, exponent).size(); };
+		}},
+		{"multi_powmod", [](size_t n) {
+			/* Sixteen n word powers; compare sixteen times powmod. */
+			auto context = make_shared<ModularContext>(BigInt(randomWords(n)) | 1u);
+			vector<BigInt> bases, exponents;
+			for (size_t i = 0; i < 16; i++)
+			{
+				bases.push_back(BigInt(randomWords(n)));
+				exponents.push_back(BigInt(randomWords(n)));
+			}
+			return [=]() { sink = context->multiPowmod(bases, exponents).size(); };
+		}},
+		{"fixed_powmod", [](size_t n) {
+			/* The table points at the context, so the run keeps both. */
+			auto context = make_shared<ModularContext>(BigInt(randomWords(n)) | 1u);
+			auto fixed = make_shared<FixedBasePowmod>(*context, BigInt(randomWords(n)), 32 * n);
+			BigInt exponent(randomWords(n));
+			return [context, fixed, exponent]() { sink = fixed->pow(exponent).size(); };
+		}},
+		{"mod", [](size_t n) {
+			BigInt a(randomWords(2 * n)), b(randomWords(n));
+			return [=]() { sink = (a % b).size(); };
+		}},
+		{"mod_word", [](size_t n) {
+			BigInt a(randomWords(n));
+			return [=]() { sink = a % 0x9E3779B9u; };
+		}},
+		{"lshift", [](size_t n) {
+			BigInt a(randomWords(n));
+			return [=]() { sink = (a << 45).size(); };
+		}},
+		{"rshift", [](size_t n) {
+			BigInt a(randomWords(n));
+			return [=]() { sink = (a >> 45).size(); };
+		}},
+		{"compare", [](size_t n) {
+			BigInt a(randomWords(n)), b(a + BigInt(1));
+			return [=]() { sink = a < b; };
+		}},
+		{"parse", [](size_t n) {
+			string decimal(randomWords(n));
+			return [=]() { sink = BigInt(decimal).size(); };
+		}},
+		{"to_string", [](size_t n) {
+			BigInt a(randomWords(n));
+			return [=]() { sink = string(a).size(); };
+		}}
+	};
+
+	vector<size_t> sizes;
+	for (size_t words = 1; words <= maxWords; words *= 2)
+		sizes.push_back(words);
+
+	if (sizes.empty() || sizes.back() != maxWords)
+		sizes.push_back(maxWords);
+
+	bool first = true;
+
+	cout << "{" << endl;
+	cout << "  \"context\": {\"max_words\": " << maxWords << ", \"min_seconds\": " << minSeconds << "}," << endl;
+	cout << "  \"benchmarks\": [";
+
+	for (auto& benchmark : benchmarks)
+	{
+		for (auto words : sizes)
+		{
+			if (benchmark.maxWords != 0 && words > benchmark.maxWords)
+				break;
+
+			auto start = chrono::steady_clock::now();
+			function<void()> run(benchmark.setup(words));
+			double setupSeconds = seconds(start);
+
+			Result result(measure(benchmark.name, words, run, minSeconds));
+
+			cout << (first ? "" : ",") << endl;
+			cout << "    {\"name\": \"" << result.name << "/" << result.words << "\", "
+			     << "\"operation\": \"" << result.name << "\", "
+			     << "\"words\": " << result.words << ", "
+			     << "\"iterations\": " << result.iterations << ", "
+			     << "\"ns_per_op\": " << result.nanoseconds << "}";
+
+			first = false;
+
+			if (result.nanoseconds > cutoffSeconds * 1e9 || setupSeconds > cutoffSeconds)
+				break;
+		}
+	}
+
+	cout << endl << "  ]" << endl << "}" << endl;
+
+	return 0;
+}
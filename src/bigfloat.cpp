@@ -0,0 +1,700 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "bigfloat.hpp"
+
+namespace
+{
+	const double log10Of2 = 0.30102999566398120;
+
+	BigInt magnitudeOf(const BigInt& value)
+	{
+		return value.isNegative() ? -value : value;
+	}
+
+	/* value * 2^bits, for the non-negative bits a BigInt shift can take. */
+	BigInt shifted(const BigInt& value, const int64_t bits)
+	{
+		if (bits > std::numeric_limits<uint32_t>::max())
+			throw std::overflow_error("BigFloat exponent out of range");
+
+		return value << static_cast<uint32_t>(bits);
+	}
+
+	BigInt powerOfTen(uint64_t exponent)
+	{
+		BigInt power(1), base(10);
+
+		for (; exponent != 0; exponent >>= 1)
+		{
+			if (exponent & 1)
+				power *= base;
+
+			if (exponent > 1)
+				base *= base;
+		}
+
+		return power;
+	}
+
+	/* floor(sqrt(n)). The root of n without its low 2k bits, scaled back up
+	 * by 2^k, is above the answer by at most about 2^k, which Newton's
+	 * iteration from above then closes in a step or two; so the work is
+	 * dominated by the divisions at full size.
+	 */
+	BigInt isqrt(const BigInt& n)
+	{
+		const size_t size = n.size();
+
+		if (size <= 2)
+			return BigInt(n.isZero() ? 0 : 1);
+
+		const uint32_t k = static_cast<uint32_t>(std::max<size_t>(size / 4, 1));
+		BigInt x((isqrt(n >> (2 * k)) + 1u) << k);
+
+		while (true)
+		{
+			BigInt y((x + n / x) >> 1);
+
+			if (y >= x)
+				return x;
+
+			x = std::move(y);
+		}
+	}
+
+	/* At least two digits, as printf does. */
+	std::string exponentSuffix(const int64_t exponent10)
+	{
+		std::string digits(std::to_string(exponent10 < 0 ? -exponent10 : exponent10));
+
+		if (digits.size() < 2)
+			digits.insert(0, "0");
+
+		return (exponent10 < 0 ? "e-" : "e+") + digits;
+	}
+
+	std::string scientific(const std::string& digits, const int64_t exponent10)
+	{
+		std::string text(digits, 0, 1);
+
+		if (digits.size() > 1)
+			text += "." + digits.substr(1);
+
+		return text + exponentSuffix(exponent10);
+	}
+}
+
+BigFloat::Rounding BigFloat::rounding = BigFloat::Rounding::ToNearest;
+size_t BigFloat::defaultPrecision = 256;
+
+BigFloat::BigFloat() : scale(0), width(defaultPrecision)
+{
+}
+
+BigFloat::BigFloat(const BigInt& value, const size_t precision) : scale(0), width(precision)
+{
+	assignRounded(magnitudeOf(value), value.isNegative(), 0, false, precision);
+}
+
+BigFloat::BigFloat(const double value, const size_t precision) : scale(0), width(precision)
+{
+	if (!std::isfinite(value))
+		throw std::invalid_argument("not a finite number");
+
+	/* A double's significand is an integer of at most 53 bits. */
+	int exponent;
+	const double fraction = std::frexp(std::fabs(value), &exponent);
+	const uint64_t whole = static_cast<uint64_t>(std::ldexp(fraction, 53));
+
+	assignRounded(BigInt() + whole, value < 0, exponent - 53, false, precision);
+}
+
+BigFloat::BigFloat(const std::string& str, const size_t precision) : scale(0), width(precision)
+{
+	const size_t length = str.length();
+	size_t i = 0;
+	bool negative = false;
+
+	if (i < length && (str[i] == '-' || str[i] == '+'))
+		negative = str[i++] == '-';
+
+	std::string digits;
+	int64_t exponent10 = 0;
+	bool point = false;
+
+	for (; i < length; i++)
+	{
+		if (std::isdigit(static_cast<unsigned char>(str[i])))
+		{
+			digits.push_back(str[i]);
+
+			if (point)
+				exponent10--;
+		}
+		else if (str[i] == '.' && !point)
+			point = true;
+		else
+			break;
+	}
+
+	if (digits.empty())
+		throw std::invalid_argument("invalid number string");
+
+	if (i < length && (str[i] == 'e' || str[i] == 'E'))
+	{
+		bool negativeExponent = false;
+		int64_t written = 0;
+
+		if (++i < length && (str[i] == '-' || str[i] == '+'))
+			negativeExponent = str[i++] == '-';
+
+		const size_t first = i;
+
+		for (; i < length && std::isdigit(static_cast<unsigned char>(str[i])); i++)
+		{
+			if (written > std::numeric_limits<int64_t>::max() / 20)
+				throw std::overflow_error("BigFloat exponent out of range");
+
+			written = 10 * written + (str[i] - '0');
+		}
+
+		if (i == first)
+			throw std::invalid_argument("invalid number string");
+
+		exponent10 += negativeExponent ? -written : written;
+	}
+
+	if (i != length)
+		throw std::invalid_argument("invalid number string");
+
+	BigInt magnitude(digits);
+
+	/* The power of ten is built exactly, so one that no BigInt shift could
+	 * take (2^32 bits, about 1.29e9 digits) is refused before it is begun,
+	 * allowing for the digits themselves, which may offset it.
+	 */
+	const double limit = 4294967296.0 * log10Of2 + static_cast<double>(digits.size());
+
+	if (!magnitude.isZero() && std::fabs(static_cast<double>(exponent10)) > limit)
+		throw std::overflow_error("BigFloat exponent out of range");
+
+	if (magnitude.isZero() || exponent10 >= 0)
+		assignRounded(magnitude * powerOfTen(magnitude.isZero() ? 0 : exponent10), negative, 0, false, precision);
+	else
+		assignQuotient(std::move(magnitude), powerOfTen(-exponent10), negative, 0, precision);
+}
+
+BigFloat& BigFloat::operator=(const BigFloat& that)
+{
+	/* BigInt only assigns from a non-const reference. */
+	significand = BigInt(that.significand);
+	scale = that.scale;
+	width = that.width;
+
+	return *this;
+}
+
+BigFloat::operator BigInt() const
+{
+	if (scale >= 0)
+		return shifted(significand, scale);
+
+	/* Shifting the magnitude right truncates toward zero. */
+	if (-scale >= static_cast<int64_t>(significand.size()))
+		return BigInt();
+
+	return significand >> static_cast<uint32_t>(-scale);
+}
+
+BigFloat::operator std::string() const
+{
+	if (isZero())
+		return "0";
+
+	const size_t count = static_cast<size_t>(std::ceil(width * log10Of2)) + 1;
+	int64_t exponent10;
+	std::string digits(decimalDigits(count, exponent10));
+
+	digits.erase(digits.find_last_not_of('0') + 1);
+
+	std::string text(isNegative() ? "-" : "");
+
+	/* Positional when that needs few extra zeros, like printf's %g. */
+	if (exponent10 < -5 || exponent10 >= static_cast<int64_t>(count))
+		return text + scientific(digits, exponent10);
+
+	if (exponent10 < 0)
+		return text + "0." + std::string(static_cast<size_t>(-exponent10 - 1), '0') + digits;
+
+	const size_t whole = static_cast<size_t>(exponent10) + 1;
+
+	if (digits.size() <= whole)
+		return text + digits + std::string(whole - digits.size(), '0');
+
+	return text + digits.substr(0, whole) + "." + digits.substr(whole);
+}
+
+std::string BigFloat::toScientific(const size_t digits) const
+{
+	const size_t count = std::max<size_t>(digits, 1);
+
+	if (isZero())
+		return scientific(std::string(count, '0'), 0);
+
+	int64_t exponent10;
+	std::string text(decimalDigits(count, exponent10));
+
+	return (isNegative() ? "-" : "") + scientific(text, exponent10);
+}
+
+std::string BigFloat::toFixed(const size_t digits) const
+{
+	std::string text(scaledToInteger(static_cast<int64_t>(digits)));
+
+	if (text.size() <= digits)
+		text.insert(0, digits + 1 - text.size(), '0');
+
+	if (digits != 0)
+		text.insert(text.size() - digits, ".");
+
+	return (isNegative() ? "-" : "") + text;
+}
+
+std::ostream& operator<<(std::ostream& out, const BigFloat& value)
+{
+	const std::ios_base::fmtflags notation = out.flags() & std::ios_base::floatfield;
+	const size_t precision = out.precision() >= 0 ? static_cast<size_t>(out.precision()) : 6;
+	std::string text;
+
+	if (notation == std::ios_base::fixed)
+		text = value.toFixed(precision);
+	else if (notation == std::ios_base::scientific)
+		text = value.toScientific(precision + 1);
+	else
+		text = value;
+
+	if ((out.flags() & std::ios_base::showpos) && !value.isNegative())
+		text.insert(0, "+");
+
+	/* The string insertion applies the width, fill and adjustment. */
+	return out << text;
+}
+
+std::istream& operator>>(std::istream& in, BigFloat& value)
+{
+	std::istream::sentry sentry(in);
+
+	if (!sentry)
+		return in;
+
+	std::streambuf* buffer = in.rdbuf();
+	std::string text;
+	int c = buffer->sgetc();
+
+	auto take = [&]() {
+		text.push_back(static_cast<char>(c));
+		c = buffer->snextc();
+	};
+
+	auto isDigit = [&]() {
+		return c != std::char_traits<char>::eof() && std::isdigit(c);
+	};
+
+	/* Only what could still be part of a number is consumed; the string
+	 * constructor then decides whether it is one.
+	 */
+	if (c == '-' || c == '+')
+		take();
+
+	while (isDigit())
+		take();
+
+	if (c == '.')
+	{
+		take();
+
+		while (isDigit())
+			take();
+	}
+
+	if (c == 'e' || c == 'E')
+	{
+		take();
+
+		if (c == '-' || c == '+')
+			take();
+
+		while (isDigit())
+			take();
+	}
+
+	if (c == std::char_traits<char>::eof())
+		in.setstate(std::ios_base::eofbit);
+
+	try
+	{
+		value = BigFloat(text, value.precision());
+	}
+	catch (const std::invalid_argument&)
+	{
+		in.setstate(std::ios_base::failbit);
+	}
+	catch (const std::overflow_error&)
+	{
+		in.setstate(std::ios_base::failbit);
+	}
+
+	return in;
+}
+
+size_t BigFloat::precision() const
+{
+	return width;
+}
+
+void BigFloat::setPrecision(const size_t bits)
+{
+	assignRounded(magnitudeOf(significand), isNegative(), scale, false, bits);
+}
+
+const BigInt& BigFloat::mantissa() const
+{
+	return significand;
+}
+
+int64_t BigFloat::exponent() const
+{
+	return scale;
+}
+
+bool BigFloat::isZero() const
+{
+	return significand.isZero();
+}
+
+bool BigFloat::isNegative() const
+{
+	return significand.isNegative();
+}
+
+bool BigFloat::operator==(const BigFloat& that) const
+{
+	/* The representation is unique, so this needs no alignment. */
+	return scale == that.scale && significand == that.significand;
+}
+
+bool BigFloat::operator!=(const BigFloat& that) const
+{
+	return !(*this == that);
+}
+
+bool BigFloat::operator<(const BigFloat& that) const
+{
+	return compare(that) < 0;
+}
+
+bool BigFloat::operator>(const BigFloat& that) const
+{
+	return compare(that) > 0;
+}
+
+bool BigFloat::operator<=(const BigFloat& that) const
+{
+	return compare(that) <= 0;
+}
+
+bool BigFloat::operator>=(const BigFloat& that) const
+{
+	return compare(that) >= 0;
+}
+
+BigFloat BigFloat::operator-() const
+{
+	BigFloat copy(*this);
+	copy.significand.negate();
+	return copy;
+}
+
+BigFloat BigFloat::operator+(const BigFloat& that) const
+{
+	BigFloat copy(*this);
+	copy += that;
+	return copy;
+}
+
+BigFloat BigFloat::operator-(const BigFloat& that) const
+{
+	BigFloat copy(*this);
+	copy -= that;
+	return copy;
+}
+
+BigFloat BigFloat::operator*(const BigFloat& that) const
+{
+	BigFloat copy(*this);
+	copy *= that;
+	return copy;
+}
+
+BigFloat BigFloat::operator/(const BigFloat& that) const
+{
+	BigFloat copy(*this);
+	copy /= that;
+	return copy;
+}
+
+BigFloat& BigFloat::operator+=(const BigFloat& that)
+{
+	const size_t precision = std::max(width, that.width);
+
+	if (that.isZero() || isZero())
+	{
+		if (isZero())
+			*this = that;
+
+		width = precision;
+		return *this;
+	}
+
+	const BigFloat& larger = top() >= that.top() ? *this : that;
+	const BigFloat& smaller = &larger == this ? that : *this;
+	const bool negative = larger.isNegative();
+
+	/* Three bits below the rounded result, everything of the smaller term
+	 * is less than one unit, so only its sign can affect the rounding: the
+	 * sum lies strictly between the larger term and one unit toward the
+	 * smaller. That keeps far apart terms from being aligned bit for bit.
+	 */
+	const int64_t low = std::min(larger.scale, larger.top() - static_cast<int64_t>(precision) - 3);
+
+	if (smaller.top() <= low)
+	{
+		BigInt magnitude(shifted(magnitudeOf(larger.significand), larger.scale - low));
+
+		if (smaller.isNegative() != negative)
+			magnitude -= 1u;
+
+		assignRounded(std::move(magnitude), negative, low, true, precision);
+		return *this;
+	}
+
+	const int64_t lowest = std::min(scale, that.scale);
+	BigInt sum(shifted(significand, scale - lowest) + shifted(that.significand, that.scale - lowest));
+	const bool sumNegative = sum.isNegative();
+
+	assignRounded(magnitudeOf(sum), sumNegative, lowest, false, precision);
+	return *this;
+}
+
+BigFloat& BigFloat::operator-=(const BigFloat& that)
+{
+	return *this += -that;
+}
+
+BigFloat& BigFloat::operator*=(const BigFloat& that)
+{
+	BigInt product(significand * that.significand);
+	const bool negative = product.isNegative();
+
+	assignRounded(magnitudeOf(product), negative, scale + that.scale, false, std::max(width, that.width));
+	return *this;
+}
+
+BigFloat& BigFloat::operator/=(const BigFloat& that)
+{
+	if (that.isZero())
+		throw std::invalid_argument("division by zero");
+
+	const bool negative = isNegative() != that.isNegative();
+
+	assignQuotient(magnitudeOf(significand), magnitudeOf(that.significand), negative,
+		scale - that.scale, std::max(width, that.width));
+	return *this;
+}
+
+BigFloat sqrt(const BigFloat& value)
+{
+	if (value.isNegative())
+		throw std::invalid_argument("square root of a negative number");
+
+	const size_t precision = value.width;
+	BigFloat root(BigInt(), precision);
+
+	if (value.isZero())
+		return root;
+
+	/* Scale the mantissa up to at least 2 (precision + 2) bits, so that the
+	 * integer root has precision + 2, and to an even exponent.
+	 */
+	const size_t size = value.significand.size();
+	int64_t extra = 2 * (precision + 2) > size ? static_cast<int64_t>(2 * (precision + 2) - size) : 0;
+
+	if ((value.scale - extra) % 2 != 0)
+		extra++;
+
+	BigInt magnitude(shifted(value.significand, extra));
+	BigInt integerRoot(isqrt(magnitude));
+	const bool inexact = integerRoot * integerRoot != magnitude;
+
+	root.assignRounded(std::move(integerRoot), false, (value.scale - extra) / 2, inexact, precision);
+	return root;
+}
+
+void BigFloat::assignRounded(BigInt&& magnitude, const bool negative, int64_t exponent, const bool inexact,
+	const size_t precision)
+{
+	if (precision == 0)
+		throw std::invalid_argument("precision must be at least one bit");
+
+	width = precision;
+
+	const size_t size = magnitude.size();
+
+	if (size > precision)
+	{
+		/* The first bit dropped is the round bit; anything after it, or
+		 * beyond the magnitude altogether, makes it more than a tie.
+		 */
+		const size_t shift = size - precision;
+		const bool half = magnitude.testBit(shift - 1);
+		const bool beyond = inexact || magnitude.countTrailingZeros() < shift - 1;
+		bool away;
+
+		magnitude >>= static_cast<uint32_t>(shift);
+		exponent += static_cast<int64_t>(shift);
+
+		switch (rounding)
+		{
+		case Rounding::ToNearest:
+			away = half && (beyond || magnitude.testBit(0));
+			break;
+		case Rounding::TowardZero:
+			away = false;
+			break;
+		case Rounding::TowardNegative:
+			away = negative && (half || beyond);
+			break;
+		default:
+			away = !negative && (half || beyond);
+			break;
+		}
+
+		if (away)
+			magnitude += 1u;
+	}
+
+	if (magnitude.isZero())
+	{
+		significand = BigInt();
+		scale = 0;
+		return;
+	}
+
+	const size_t zeros = magnitude.countTrailingZeros();
+	magnitude >>= static_cast<uint32_t>(zeros);
+
+	if (negative)
+		magnitude.negate();
+
+	significand = std::move(magnitude);
+	scale = exponent + static_cast<int64_t>(zeros);
+}
+
+void BigFloat::assignQuotient(BigInt&& numerator, const BigInt& denominator, const bool negative,
+	int64_t exponent, const size_t precision)
+{
+	/* A numerator precision + 2 bits wider than the denominator gives a
+	 * quotient of at least precision + 2 bits.
+	 */
+	const size_t wanted = precision + 2 + denominator.size();
+
+	if (wanted > numerator.size())
+	{
+		const size_t extra = wanted - numerator.size();
+
+		numerator = shifted(numerator, static_cast<int64_t>(extra));
+		exponent -= static_cast<int64_t>(extra);
+	}
+
+	BigInt quotient(numerator / denominator);
+	const bool inexact = quotient * denominator != numerator;
+
+	assignRounded(std::move(quotient), negative, exponent, inexact, precision);
+}
+
+int64_t BigFloat::top() const
+{
+	return scale + static_cast<int64_t>(significand.size());
+}
+
+int BigFloat::compare(const BigFloat& that) const
+{
+	if (isNegative() != that.isNegative())
+		return isNegative() ? -1 : 1;
+
+	int order;
+
+	if (isZero() || that.isZero())
+		order = isZero() ? (that.isZero() ? 0 : -1) : 1;
+	else if (top() != that.top())
+		order = top() < that.top() ? -1 : 1;
+	else
+	{
+		/* With the tops level, the exponents differ by less than a mantissa. */
+		const int64_t lowest = std::min(scale, that.scale);
+		BigInt a(shifted(magnitudeOf(significand), scale - lowest));
+		BigInt b(shifted(magnitudeOf(that.significand), that.scale - lowest));
+
+		order = a < b ? -1 : a > b ? 1 : 0;
+	}
+
+	return isNegative() ? -order : order;
+}
+
+BigInt BigFloat::scaledToInteger(const int64_t shift) const
+{
+	BigInt numerator(magnitudeOf(significand)), denominator(1);
+
+	if (scale >= 0)
+		numerator = shifted(numerator, scale);
+	else
+		denominator = shifted(denominator, -scale);
+
+	if (shift >= 0)
+		numerator *= powerOfTen(static_cast<uint64_t>(shift));
+	else
+		denominator *= powerOfTen(static_cast<uint64_t>(-shift));
+
+	BigInt quotient(numerator / denominator);
+	BigInt twice((numerator - quotient * denominator) << 1);
+
+	if (twice > denominator || (twice == denominator && quotient.testBit(0)))
+		quotient += 1u;
+
+	return quotient;
+}
+
+std::string BigFloat::decimalDigits(const size_t digits, int64_t& exponent10) const
+{
+	/* |x| is in [2^(top - 1), 2^top), which puts the estimate of its
+	 * power of ten out by at most one; rounding up to the next power is
+	 * caught the same way.
+	 */
+	exponent10 = static_cast<int64_t>(std::floor(static_cast<double>(top() - 1) * log10Of2));
+
+	const BigInt limit(powerOfTen(digits)), least(powerOfTen(digits - 1));
+	BigInt scaled(scaledToInteger(static_cast<int64_t>(digits) - 1 - exponent10));
+
+	while (scaled >= limit)
+		scaled = scaledToInteger(static_cast<int64_t>(digits) - 1 - ++exponent10);
+
+	while (scaled < least)
+		scaled = scaledToInteger(static_cast<int64_t>(digits) - 1 - --exponent10);
+
+	return scaled;
+}
@@ -1,14 +1,94 @@
+#include <algorithm>
 #include <cctype>
-#include <iomanip>
-#include <sstream>
-#include <stack>
+#include <map>
 #include <stdexcept>
 
 #include "bigint.hpp"
+#include "counters.hpp"
+#include "tuning.hpp"
 
 BigInt BigInt::zero(0);
 BigInt BigInt::one(1);
 
+const size_t BigInt::chunkDigits;
+const uint32_t BigInt::chunkBase;
+
+size_t BigInt::parseThreshold = PARSE_THRESHOLD;
+
+namespace
+{
+	const BigInt& powerOfTen(size_t exponent, std::map<size_t, BigInt>& powers)
+	{
+		auto found = powers.find(exponent);
+		if (found != powers.end())
+			return found->second;
+
+		BigInt power(1);
+
+		/* Up to 10^9 still fits in a single word. */
+		if (exponent <= 9)
+			for (size_t i = 0; i < exponent; i++)
+				power *= 10u;
+		else
+		{
+			const BigInt& half = powerOfTen(exponent / 2, powers);
+
+			power = half * half;
+			if (exponent % 2 == 1)
+				power *= 10u;
+		}
+
+		return powers[exponent] = std::move(power);
+	}
+}
+
+BigInt BigInt::parseDigits(const std::string& str, size_t begin, size_t end,
+	std::map<size_t, BigInt>& powers)
+{
+	/* Short strings are read nine digits at a time, which is quadratic.
+	 * Longer strings are split in two, so that the work is dominated by
+	 * multiplying the high half by a power of ten.
+	 */
+	if (end - begin < parseThreshold || end - begin <= chunkDigits)
+	{
+		BIGINT_COUNT(Counter::ParseChunked, (end - begin) / chunkDigits + 1);
+
+		BigInt value;
+
+		/* Each word holds at least log10(2^32) > 9.63 digits. */
+		value.words.reserve((end - begin) * 3321929 / 32000000 + 1);
+
+		for (size_t i = begin; i < end; i += chunkDigits)
+		{
+			size_t length = std::min(chunkDigits, end - i);
+			uint32_t chunk = 0;
+			uint32_t scale = 1;
+
+			for (size_t j = i; j < i + length; j++)
+			{
+				chunk = chunk * 10 + static_cast<uint32_t>(str[j] - '0');
+				scale *= 10;
+			}
+
+			value *= scale;
+			value += BigInt::Words(1, chunk);
+		}
+
+		return value;
+	}
+
+	BIGINT_COUNT(Counter::ParseSplit, (end - begin) / chunkDigits + 1);
+
+	size_t lowDigits = (end - begin) / 2;
+	size_t middle = end - lowDigits;
+
+	BigInt value(parseDigits(str, begin, middle, powers));
+	value *= powerOfTen(lowDigits, powers);
+	value += parseDigits(str, middle, end, powers).words;
+
+	return value;
+}
+
 BigInt::BigInt() : positive(true), words(1)
 {
 	words[0] = 0;
@@ -21,6 +101,8 @@ BigInt::BigInt(uint32_t that) : positive(true), words(1)
 
 BigInt::BigInt(const std::string& str) : positive(true)
 {
+	BIGINT_TIME(Counter::Parse, str.length() / chunkDigits + 1);
+
 	if (str.length() == 0)
 		words.push_back(0);
 
@@ -29,57 +111,20 @@ BigInt::BigInt(const std::string& str) : positive(true)
 
 	else
 	{
-		std::vector<uint32_t> digits;
-		std::vector<bool> binaryDigits;
-
-		{
-			auto endIt = str.crend();
-			
-			if (str[0] == '-')
-			{
-				positive = false;
-				--endIt;
-			}
-
-			for (auto it = str.crbegin(); it != endIt; ++it)
-			{
-				if (! std::isdigit(*it))
-					throw std::invalid_argument("invalid number string");
-
-				digits.push_back(*it - '0');
-			}
-		}
-
-		/* We can treat digits as a base-10 big integer in little endian order.
-		 * If we divide the number through by 2 until it is zero, then the
-		 * remainders of those divisions will be the binary digits of the
-		 * base-2 integer in little endian order.
-		 */
-		while (!digits.empty())
-		{
-			uint32_t remainder = 0;
-
-			for (auto digit = digits.rbegin(); digit != digits.rend(); ++digit)
-			{
-				*digit += remainder * 10;
-				remainder = *digit % 2;
-				*digit /= 2;
-			}
-
-			binaryDigits.push_back(remainder == 1);
+		size_t begin = str[0] == '-' ? 1 : 0;
 
-			while (!digits.empty() && digits.back() == 0)
-				digits.pop_back();
-		}
+		for (size_t i = begin; i < str.length(); i++)
+			if (! std::isdigit(static_cast<unsigned char>(str[i])))
+				throw std::invalid_argument("invalid number string");
 
-		words = BigInt::binaryToWords(binaryDigits);
+		std::map<size_t, BigInt> powers;
 
-		if (words.empty())
-			words.push_back(0);
+		*this = parseDigits(str, begin, str.length(), powers);
+		positive = begin == 0;
 
 		if (isZero() && !positive)
 			throw std::invalid_argument("invalid number string");
-	}		
+	}
 }
 
 BigInt::BigInt(const BigInt& that) : positive(that.positive), words(that.words)
@@ -94,7 +139,7 @@ BigInt::BigInt(const BigInt::Words& that, bool sign) : positive(sign), words(tha
 {
 }
 
-BigInt::BigInt(const BigInt::Words&& that, bool sign) : positive(sign), words(that)
+BigInt::BigInt(BigInt::Words&& that, bool sign) : positive(sign), words(std::move(that))
 {
 }
 
@@ -116,56 +161,64 @@ BigInt& BigInt::operator=(BigInt&& that)
 
 BigInt::operator std::string() const
 {
-	/* Largest power of 10 under 2^32 */
-	const uint32_t divisor = 1000000000;
+	BIGINT_TIME(Counter::ToString, words.size());
 
-	if (words.size() == 1 && words.front() == 0)
-		return std::string("0");
-	else
-	{
-		std::stringstream builder;
-		std::string part;
-		std::stack<std::string> parts;
+	BigInt::Words chunks(decimalChunks());
+	std::string str;
 
-		BigInt copy(*this);
-		uint32_t digits;
+	str.reserve(chunkDigits * chunks.size() + 1);
+	BIGINT_ALLOCATION(Counter::ToString);
 
-		if (!positive)
+	if (!positive)
+		str.push_back('-');
+
+	str += std::to_string(chunks.back());
+
+	for (size_t i = chunks.size() - 1; i > 0; i--)
+	{
+		char digits[chunkDigits];
+		uint32_t chunk = chunks[i - 1];
+
+		for (size_t j = chunkDigits; j > 0; j--)
 		{
-			builder << '-';
-			copy.negate();
+			digits[j - 1] = static_cast<char>('0' + chunk % 10);
+			chunk /= 10;
 		}
 
-		while (!copy.isZero())
-		{
-			std::stringstream partBuilder;
+		str.append(digits, chunkDigits);
+	}
 
-			if (copy > divisor)
-			{
-				digits = copy % divisor;
-				copy /= divisor;
+	return str;
+}
 
-				partBuilder << std::setw(9) << std::setfill('0') << digits;
-			}
-			else
-			{
-				digits = copy.words.back();
-				copy = zero;
-				partBuilder << digits;
-			}
+BigInt::Words BigInt::decimalChunks() const
+{
+	/* Repeatedly dividing the magnitude by 10^9 in place yields its base 10^9
+	 * digits, least significant first.
+	 */
+	BigInt::Words magnitude(words), chunks;
 
-			partBuilder >> part;
-			parts.push(part);
-		}
+	chunks.reserve(words.size() + words.size() / 8 + 1);
+
+	do
+	{
+		uint64_t remainder = 0;
 
-		while (!parts.empty())
+		for (size_t i = magnitude.size(); i > 0; i--)
 		{
-			builder << parts.top();
-			parts.pop();
+			remainder = (remainder << 32) + magnitude[i - 1];
+			magnitude[i - 1] = static_cast<uint32_t>(remainder / chunkBase);
+			remainder %= chunkBase;
 		}
 
-		return builder.str();
+		chunks.push_back(static_cast<uint32_t>(remainder));
+
+		while (magnitude.size() > 1 && magnitude.back() == 0)
+			magnitude.pop_back();
 	}
+	while (magnitude.size() > 1 || magnitude[0] != 0);
+
+	return chunks;
 }
 
 bool BigInt::isZero() const
@@ -187,16 +240,57 @@ size_t BigInt::size() const
 {
 	/* The size of the number is the number of bits in each word.
 	 * We know that all but the last word is guaranteed to be full. The last
-	 * word (i.e. the msb) has a variable number of bits, so we count those and
-	 * add it to the total.
+	 * word (i.e. the msb) has a variable number of bits, which are found by
+	 * counting its leading zeros.
 	 */
 	size_t size = 32 * (words.size() - 1);
-	for (uint32_t msb = words.back(); msb != 0; msb >>= 1)
-		size++;
+	if (words.back() != 0)
+		size += 32 - __builtin_clz(words.back());
 
 	return size;
 }
 
+void BigInt::truncateWords(const size_t count)
+{
+	if (words.size() > count)
+	{
+		words.resize(count);
+		trim();
+	}
+}
+
+uint64_t BigInt::magnitudeOf(const int64_t that)
+{
+	/* Negating as unsigned is well defined even for INT64_MIN. */
+	return that < 0 ? 0 - static_cast<uint64_t>(that) : static_cast<uint64_t>(that);
+}
+
+void BigInt::assignScalar(const bool negative, const uint64_t magnitude)
+{
+	words.resize(magnitude >> 32 == 0 ? 1 : 2);
+	words[0] = static_cast<uint32_t>(magnitude);
+
+	if (words.size() == 2)
+		words[1] = static_cast<uint32_t>(magnitude >> 32);
+
+	positive = !negative || magnitude == 0;
+}
+
+void BigInt::reserve(const size_t bits)
+{
+	words.reserve((bits + 31) / 32);
+}
+
+size_t BigInt::capacity() const
+{
+	return 32 * words.capacity();
+}
+
+void BigInt::shrink_to_fit()
+{
+	words.shrink_to_fit();
+}
+
 void BigInt::trim()
 {
 	/* We always ensure that the words.size() is at least one (even if words[0] == 0). */
@@ -208,6 +302,8 @@ BigInt::Words BigInt::binaryToWords(const std::vector<bool>& binaryDigits)
 {
 	BigInt::Words words;
 
+	words.reserve((binaryDigits.size() + 31) / 32);
+
 	for (size_t i = 0; i < binaryDigits.size(); i += 32)
 	{
 		uint32_t word = 0;
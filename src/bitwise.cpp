@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <functional>
+
+#include "bigint.hpp"
+
+BigInt BigInt::operator&(const BigInt& that) const
+{
+	BigInt copy(*this);
+	copy &= that;
+	return copy;
+}
+
+BigInt BigInt::operator|(const BigInt& that) const
+{
+	BigInt copy(*this);
+	copy |= that;
+	return copy;
+}
+
+BigInt BigInt::operator^(const BigInt& that) const
+{
+	BigInt copy(*this);
+	copy ^= that;
+	return copy;
+}
+
+BigInt BigInt::operator~() const
+{
+	BigInt copy(*this);
+	copy.negate();
+	copy -= one;
+	return copy;
+}
+
+BigInt& BigInt::operator&=(const BigInt& that)
+{
+	return bitwise(that, std::bit_and<uint32_t>());
+}
+
+BigInt& BigInt::operator|=(const BigInt& that)
+{
+	return bitwise(that, std::bit_or<uint32_t>());
+}
+
+BigInt& BigInt::operator^=(const BigInt& that)
+{
+	return bitwise(that, std::bit_xor<uint32_t>());
+}
+
+template <typename Operation>
+BigInt& BigInt::bitwise(const BigInt& that, Operation operation)
+{
+	const size_t size = std::max(words.size(), that.words.size());
+	const bool negative = operation(positive ? 0u : 1u, that.positive ? 0u : 1u) != 0;
+
+	words.resize(size, 0);
+
+	/* The words are this copy's own from here on, so the loops can work
+	 * through plain pointers. that may be this, so it is read after.
+	 */
+	uint32_t* w = words.data();
+	const uint32_t* other = that.words.data();
+	const size_t otherSize = that.words.size();
+
+	if (positive && that.positive)
+	{
+		/* Both are their own two's complement, so this is one straight pass. */
+		for (size_t i = 0; i < otherSize; i++)
+			w[i] = operation(w[i], other[i]);
+
+		for (size_t i = otherSize; i < size; i++)
+			w[i] = operation(w[i], 0u);
+	}
+	else
+	{
+		/* The two's complement of a magnitude m is ~m + 1, with the carry out
+		 * of the + 1 running only as far as the lowest set word. Both
+		 * operands and the result are converted on the fly as the words go
+		 * by.
+		 */
+		uint32_t carry = 1, thatCarry = 1, resultCarry = 1;
+
+		for (size_t i = 0; i < size; i++)
+		{
+			uint32_t word = w[i], thatWord = i < otherSize ? other[i] : 0;
+
+			if (!positive)
+			{
+				uint32_t inverted = ~word + carry;
+				carry &= word == 0;
+				word = inverted;
+			}
+
+			if (!that.positive)
+			{
+				uint32_t inverted = ~thatWord + thatCarry;
+				thatCarry &= thatWord == 0;
+				thatWord = inverted;
+			}
+
+			uint32_t result = operation(word, thatWord);
+
+			if (negative)
+			{
+				uint32_t inverted = ~result + resultCarry;
+				resultCarry &= result == 0;
+				result = inverted;
+			}
+
+			w[i] = result;
+		}
+
+		/* Past the top word a negative result is all ones, whose complement
+		 * only matters if the carry got that far.
+		 */
+		if (negative && resultCarry)
+			words.resize(size + 1, 1);
+	}
+
+	positive = !negative;
+	trim();
+
+	return *this;
+}
+
+size_t BigInt::popcount() const
+{
+	size_t count = 0;
+
+	for (auto word : words)
+		count += __builtin_popcount(word);
+
+	return count;
+}
+
+size_t BigInt::countTrailingZeros() const
+{
+	for (size_t i = 0; i < words.size(); i++)
+		if (words[i] != 0)
+			return 32 * i + __builtin_ctz(words[i]);
+
+	return 0;
+}
+
+bool BigInt::testBit(const size_t bit) const
+{
+	const size_t word = bit / 32;
+	const bool set = word < words.size() && (words[word] >> (bit % 32) & 1) != 0;
+
+	if (positive)
+		return set;
+
+	/* Below the lowest set bit, -m has the same (zero) bits as m; that bit
+	 * itself is shared; every bit above it is inverted.
+	 */
+	const size_t lowest = countTrailingZeros();
+
+	return bit <= lowest ? set : !set;
+}
+
+void BigInt::setBit(const size_t bit, const bool value)
+{
+	if (testBit(bit) == value)
+		return;
+
+	if (positive)
+	{
+		/* The bit is in the magnitude itself, so flip it in place. */
+		if (bit / 32 >= words.size())
+			words.resize(bit / 32 + 1, 0);
+
+		words[bit / 32] ^= 1u << (bit % 32);
+		trim();
+		return;
+	}
+
+	/* Setting a clear bit adds 2^bit in any two's complement, and clearing a
+	 * set bit subtracts it.
+	 */
+	BigInt power(one << static_cast<uint32_t>(bit));
+
+	if (value)
+		*this += power;
+	else
+		*this -= power;
+}
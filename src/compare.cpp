@@ -98,4 +98,113 @@ bool BigInt::operator>=(const BigInt& that) const
 bool BigInt::operator>=(const uint32_t that) const
 {
 	return !(*this < that);
-}
\ No newline at end of file
+}
+
+int BigInt::compareScalar(const bool negative, const uint64_t magnitude) const
+{
+	const bool thatPositive = !negative || magnitude == 0;
+
+	if (positive != thatPositive)
+		return positive ? 1 : -1;
+
+	/* With more than two words, |this| can't fit in a uint64_t. */
+	int order = 1;
+
+	if (words.size() <= 2)
+	{
+		uint64_t value = words[0] | (words.size() == 2 ? static_cast<uint64_t>(words[1]) << 32 : 0);
+		order = value < magnitude ? -1 : value > magnitude;
+	}
+
+	return positive ? order : -order;
+}
+
+bool BigInt::operator==(const int that) const
+{
+	return *this == static_cast<int64_t>(that);
+}
+
+bool BigInt::operator==(const int64_t that) const
+{
+	return compareScalar(that < 0, magnitudeOf(that)) == 0;
+}
+
+bool BigInt::operator==(const uint64_t that) const
+{
+	return compareScalar(false, that) == 0;
+}
+
+bool BigInt::operator!=(const int that) const
+{
+	return *this != static_cast<int64_t>(that);
+}
+
+bool BigInt::operator!=(const int64_t that) const
+{
+	return compareScalar(that < 0, magnitudeOf(that)) != 0;
+}
+
+bool BigInt::operator!=(const uint64_t that) const
+{
+	return compareScalar(false, that) != 0;
+}
+
+bool BigInt::operator<(const int that) const
+{
+	return *this < static_cast<int64_t>(that);
+}
+
+bool BigInt::operator<(const int64_t that) const
+{
+	return compareScalar(that < 0, magnitudeOf(that)) < 0;
+}
+
+bool BigInt::operator<(const uint64_t that) const
+{
+	return compareScalar(false, that) < 0;
+}
+
+bool BigInt::operator>(const int that) const
+{
+	return *this > static_cast<int64_t>(that);
+}
+
+bool BigInt::operator>(const int64_t that) const
+{
+	return compareScalar(that < 0, magnitudeOf(that)) > 0;
+}
+
+bool BigInt::operator>(const uint64_t that) const
+{
+	return compareScalar(false, that) > 0;
+}
+
+bool BigInt::operator<=(const int that) const
+{
+	return *this <= static_cast<int64_t>(that);
+}
+
+bool BigInt::operator<=(const int64_t that) const
+{
+	return compareScalar(that < 0, magnitudeOf(that)) <= 0;
+}
+
+bool BigInt::operator<=(const uint64_t that) const
+{
+	return compareScalar(false, that) <= 0;
+}
+
+bool BigInt::operator>=(const int that) const
+{
+	return *this >= static_cast<int64_t>(that);
+}
+
+bool BigInt::operator>=(const int64_t that) const
+{
+	return compareScalar(that < 0, magnitudeOf(that)) >= 0;
+}
+
+bool BigInt::operator>=(const uint64_t that) const
+{
+	return compareScalar(false, that) >= 0;
+}
@@ -0,0 +1,117 @@
+#include <atomic>
+
+#include "counters.hpp"
+
+namespace
+{
+	const char* names[] = {
+		"multiply",
+		"multiply.schoolbook",
+		"multiply.karatsuba",
+		"multiply.word",
+		"divide",
+		"divide.word",
+		"modulo",
+		"to_string",
+		"parse",
+		"parse.chunked",
+		"parse.split"
+	};
+
+	static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(Counter::Count),
+		"every counter needs a name");
+
+	struct AtomicValues
+	{
+		std::atomic<uint64_t> calls;
+		std::atomic<uint64_t> limbs;
+		std::atomic<uint64_t> allocations;
+		std::atomic<uint64_t> nanoseconds;
+	};
+
+	AtomicValues values[static_cast<size_t>(Counter::Count)];
+}
+
+std::vector<CounterValues> snapshotCounters()
+{
+	std::vector<CounterValues> snapshot;
+
+	for (size_t i = 0; i < static_cast<size_t>(Counter::Count); i++)
+	{
+		snapshot.push_back(CounterValues {
+			names[i],
+			values[i].calls.load(std::memory_order_relaxed),
+			values[i].limbs.load(std::memory_order_relaxed),
+			values[i].allocations.load(std::memory_order_relaxed),
+			values[i].nanoseconds.load(std::memory_order_relaxed)
+		});
+	}
+
+	return snapshot;
+}
+
+void resetCounters()
+{
+	for (auto& value : values)
+	{
+		value.calls.store(0, std::memory_order_relaxed);
+		value.limbs.store(0, std::memory_order_relaxed);
+		value.allocations.store(0, std::memory_order_relaxed);
+		value.nanoseconds.store(0, std::memory_order_relaxed);
+	}
+}
+
+#ifdef BIGINT_INSTRUMENT
+
+namespace
+{
+	AtomicValues& at(Counter counter)
+	{
+		return values[static_cast<size_t>(counter)];
+	}
+
+	thread_local CounterScope* innermost = nullptr;
+}
+
+void countCall(Counter counter, size_t limbs)
+{
+	at(counter).calls.fetch_add(1, std::memory_order_relaxed);
+	at(counter).limbs.fetch_add(limbs, std::memory_order_relaxed);
+}
+
+void countAllocation(Counter counter)
+{
+	at(counter).allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void countTime(Counter counter, uint64_t nanoseconds)
+{
+	at(counter).nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+void countScopeAllocation()
+{
+	if (innermost != nullptr)
+		countAllocation(innermost->counter);
+}
+
+CounterScope::CounterScope(Counter counter, size_t limbs)
+	: counter(counter), outer(innermost), start(std::chrono::steady_clock::now())
+{
+	countCall(counter, limbs);
+	innermost = this;
+}
+
+CounterScope::~CounterScope()
+{
+	innermost = outer;
+
+	if (outer == nullptr)
+	{
+		auto elapsed = std::chrono::steady_clock::now() - start;
+
+		countTime(counter, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+	}
+}
+
+#endif
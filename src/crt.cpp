@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <stdexcept>
+
+#include "crt.hpp"
+#include "tree.hpp"
+
+namespace
+{
+	/* a^-1 mod m, by the extended Euclidean algorithm, for coprime a and m. */
+	uint32_t inverse(const uint32_t a, const uint32_t m)
+	{
+		int64_t t = 0, nextT = 1;
+		int64_t r = m, nextR = a % m;
+
+		while (nextR != 0)
+		{
+			const int64_t q = r / nextR;
+			const int64_t oldT = t, oldR = r;
+
+			t = nextT;
+			nextT = oldT - q * nextT;
+			r = nextR;
+			nextR = oldR - q * nextR;
+		}
+
+		if (r != 1)
+			throw std::invalid_argument("moduli must be pairwise coprime");
+
+		return static_cast<uint32_t>(t < 0 ? t + m : t);
+	}
+
+	void requireModuli(const std::vector<uint32_t>& moduli)
+	{
+		for (uint32_t m : moduli)
+			if (m == 0)
+				throw std::invalid_argument("division by zero");
+	}
+}
+
+std::vector<uint32_t> residues(const BigInt& x, const std::vector<uint32_t>& moduli)
+{
+	requireModuli(moduli);
+
+	const size_t count = moduli.size();
+
+	/* With v = (2^64 - 1) / m, the high word of n v falls short of n / m by
+	 * at most two, for any n below 2^64.
+	 */
+	std::vector<uint64_t> reciprocals(count);
+	std::vector<uint32_t> result(count, 0);
+
+	for (size_t i = 0; i < count; i++)
+		reciprocals[i] = UINT64_MAX / moduli[i];
+
+	for (auto word = x.words.crbegin(); word != x.words.crend(); ++word)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			const uint64_t m = moduli[i];
+			const uint64_t n = (static_cast<uint64_t>(result[i]) << 32) | *word;
+			const uint64_t q = static_cast<uint64_t>((static_cast<unsigned __int128>(n) * reciprocals[i]) >> 64);
+
+			uint64_t remainder = n - q * m;
+
+			if (remainder >= m)
+				remainder -= m;
+			if (remainder >= m)
+				remainder -= m;
+
+			result[i] = static_cast<uint32_t>(remainder);
+		}
+	}
+
+	if (x.isNegative())
+		for (size_t i = 0; i < count; i++)
+			if (result[i] != 0)
+				result[i] = moduli[i] - result[i];
+
+	return result;
+}
+
+CRTContext::CRTContext(const std::vector<uint32_t>& moduli) : divisors(moduli), modulus(1)
+{
+	requireModuli(moduli);
+
+	const size_t count = moduli.size();
+
+	if (count <= garnerLimit)
+	{
+		/* The product of the earlier moduli, modulo each. */
+		for (size_t j = 0; j < count; j++)
+		{
+			uint64_t earlier = 1;
+
+			for (size_t l = 0; l < j; l++)
+				earlier = earlier * moduli[l] % moduli[j];
+
+			inverses.push_back(inverse(static_cast<uint32_t>(earlier), moduli[j]));
+			modulus *= moduli[j];
+		}
+
+		return;
+	}
+
+	std::vector<BigInt> leaves, squares;
+
+	for (uint32_t m : moduli)
+	{
+		leaves.push_back(BigInt(m));
+		squares.push_back(BigInt(m) * m);
+	}
+
+	tree = productTree(leaves);
+	modulus = BigInt(tree[0]);
+
+	/* M mod m^2 is m (M / m mod m), so a remainder tree over the squares
+	 * gives every cofactor M / m modulo its own m at once.
+	 */
+	std::vector<BigInt> remainders(remaindersOf(modulus, squares));
+
+	for (size_t i = 0; i < count; i++)
+		inverses.push_back(inverse((remainders[i] / moduli[i]) % moduli[i], moduli[i]));
+}
+
+size_t CRTContext::size() const
+{
+	return divisors.size();
+}
+
+const std::vector<uint32_t>& CRTContext::moduli() const
+{
+	return divisors;
+}
+
+const BigInt& CRTContext::product() const
+{
+	return modulus;
+}
+
+BigInt CRTContext::combine(const std::vector<uint32_t>& residues) const
+{
+	if (residues.size() != size())
+		throw std::invalid_argument("there must be a residue for every modulus");
+
+	if (tree.empty())
+		return garner(residues);
+
+	return ascend(residues, 0, 0, size(), defaultThreads()) % modulus;
+}
+
+std::vector<uint32_t> CRTContext::reduce(const BigInt& x) const
+{
+	if (tree.empty())
+		return residues(x, divisors);
+
+	std::vector<uint32_t> result(size());
+	descend(x % modulus, result, 0, 0, size());
+
+	return result;
+}
+
+BigInt CRTContext::garner(const std::vector<uint32_t>& residues) const
+{
+	const size_t count = size();
+
+	if (count == 0)
+		return BigInt(0);
+
+	/* Digit j is worth the product of the moduli before it; the value of
+	 * the earlier digits modulo m_j is taken by Horner's rule from the top.
+	 */
+	std::vector<uint32_t> digits(count);
+
+	for (size_t j = 0; j < count; j++)
+	{
+		const uint64_t m = divisors[j];
+		uint64_t earlier = 0;
+
+		for (size_t l = j; l > 0; l--)
+			earlier = (earlier * divisors[l - 1] + digits[l - 1]) % m;
+
+		const uint64_t difference = (residues[j] % m + m - earlier) % m;
+		digits[j] = static_cast<uint32_t>(difference * inverses[j] % m);
+	}
+
+	BigInt value(digits[count - 1]);
+
+	for (size_t j = count - 1; j > 0; j--)
+	{
+		value *= divisors[j - 1];
+		value += digits[j - 1];
+	}
+
+	return value;
+}
+
+BigInt CRTContext::ascend(const std::vector<uint32_t>& residues, const size_t node, const size_t begin,
+	const size_t end, const unsigned threads) const
+{
+	if (end - begin == 1)
+	{
+		const uint64_t m = divisors[begin];
+		return BigInt(static_cast<uint32_t>(residues[begin] % m * inverses[begin] % m));
+	}
+
+	const size_t mid = begin + (end - begin) / 2;
+	const size_t left = node + 1, right = rightChild(node, begin, mid);
+	BigInt leftValue, rightValue;
+
+	if (threads > 1 && end - begin >= parallelCutoff)
+	{
+		std::future<BigInt> pending = std::async(std::launch::async, &CRTContext::ascend, this,
+			std::cref(residues), left, begin, mid, threads / 2);
+		rightValue = ascend(residues, right, mid, end, threads - threads / 2);
+		leftValue = pending.get();
+	}
+	else
+	{
+		leftValue = ascend(residues, left, begin, mid, 1);
+		rightValue = ascend(residues, right, mid, end, 1);
+	}
+
+	/* Each side's terms carry the other side's moduli as factors. */
+	return leftValue * tree[right] + rightValue * tree[left];
+}
+
+void CRTContext::descend(const BigInt& x, std::vector<uint32_t>& result, const size_t node, const size_t begin,
+	const size_t end) const
+{
+	if (end - begin <= leafSize)
+	{
+		const std::vector<uint32_t> group(divisors.begin() + begin, divisors.begin() + end);
+		const std::vector<uint32_t> remainders(residues(x, group));
+
+		std::copy(remainders.begin(), remainders.end(), result.begin() + begin);
+		return;
+	}
+
+	const size_t mid = begin + (end - begin) / 2;
+	const size_t left = node + 1, right = rightChild(node, begin, mid);
+
+	descend(x % tree[left], result, left, begin, mid);
+	descend(x % tree[right], result, right, mid, end);
+}
+
+BigInt crt(const std::vector<uint32_t>& residues, const std::vector<uint32_t>& moduli)
+{
+	return CRTContext(moduli).combine(residues);
+}
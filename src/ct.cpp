@@ -0,0 +1,161 @@
+#include <vector>
+
+#include "ct.hpp"
+
+namespace
+{
+	/* All ones if bit is 1, all zeros if bit is 0. */
+	uint32_t mask(uint32_t bit)
+	{
+		return -bit;
+	}
+
+	/* 1 if word is zero, otherwise 0. */
+	uint32_t isZero(uint32_t word)
+	{
+		uint64_t wide = word;
+		return static_cast<uint32_t>(((wide | (0 - wide)) >> 63) ^ 1);
+	}
+
+	/* r = a * b, where r is 2n words. */
+	void multiply(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n)
+	{
+		for (size_t i = 0; i < 2 * n; i++)
+			r[i] = 0;
+
+		for (size_t i = 0; i < n; i++)
+		{
+			uint64_t carry = 0;
+
+			for (size_t j = 0; j < n; j++)
+			{
+				uint64_t product = static_cast<uint64_t>(a[i]) * b[j] + r[i + j] + carry;
+
+				r[i + j] = static_cast<uint32_t>(product);
+				carry = product >> 32;
+			}
+
+			r[i + n] = static_cast<uint32_t>(carry);
+		}
+	}
+
+	/* r = x mod m, where x is 2n words and m is n words.
+	 *
+	 * We feed the bits of x into a running remainder from the top, shifting
+	 * one bit in and then conditionally subtracting m. The remainder is kept
+	 * one word wider than m so the shift cannot overflow.
+	 */
+	void reduce(uint32_t* r, const uint32_t* x, const uint32_t* m, size_t n)
+	{
+		std::vector<uint32_t> remainder(n + 1, 0), difference(n + 1), modulus(m, m + n);
+
+		modulus.push_back(0);
+
+		for (size_t i = 64 * n; i > 0; i--)
+		{
+			uint32_t bit = (x[(i - 1) / 32] >> ((i - 1) % 32)) & 1;
+
+			for (size_t j = n + 1; j > 1; j--)
+				remainder[j - 1] = (remainder[j - 1] << 1) | (remainder[j - 2] >> 31);
+			remainder[0] = (remainder[0] << 1) | bit;
+
+			uint32_t borrow = ct_sub(difference.data(), remainder.data(), modulus.data(), n + 1);
+			ct_select(remainder.data(), remainder.data(), difference.data(), n + 1, borrow);
+		}
+
+		for (size_t i = 0; i < n; i++)
+			r[i] = remainder[i];
+	}
+}
+
+uint32_t ct_add(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n)
+{
+	uint64_t carry = 0;
+
+	for (size_t i = 0; i < n; i++)
+	{
+		uint64_t sum = static_cast<uint64_t>(a[i]) + b[i] + carry;
+
+		r[i] = static_cast<uint32_t>(sum);
+		carry = sum >> 32;
+	}
+
+	return static_cast<uint32_t>(carry);
+}
+
+uint32_t ct_sub(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n)
+{
+	uint64_t borrow = 0;
+
+	for (size_t i = 0; i < n; i++)
+	{
+		uint64_t difference = static_cast<uint64_t>(a[i]) - b[i] - borrow;
+
+		r[i] = static_cast<uint32_t>(difference);
+		borrow = difference >> 63;
+	}
+
+	return static_cast<uint32_t>(borrow);
+}
+
+void ct_select(uint32_t* r, const uint32_t* a, const uint32_t* b, size_t n, uint32_t choice)
+{
+	uint32_t chooseA = mask(choice);
+
+	for (size_t i = 0; i < n; i++)
+		r[i] = (a[i] & chooseA) | (b[i] & ~chooseA);
+}
+
+uint32_t ct_equal(const uint32_t* a, const uint32_t* b, size_t n)
+{
+	uint32_t difference = 0;
+
+	for (size_t i = 0; i < n; i++)
+		difference |= a[i] ^ b[i];
+
+	return isZero(difference);
+}
+
+uint32_t ct_less(const uint32_t* a, const uint32_t* b, size_t n)
+{
+	/* a < b exactly when a - b borrows. */
+	uint64_t borrow = 0;
+
+	for (size_t i = 0; i < n; i++)
+		borrow = (static_cast<uint64_t>(a[i]) - b[i] - borrow) >> 63;
+
+	return static_cast<uint32_t>(borrow);
+}
+
+void ct_mulmod(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* m, size_t n)
+{
+	std::vector<uint32_t> product(2 * n);
+
+	multiply(product.data(), a, b, n);
+	reduce(r, product.data(), m, n);
+}
+
+void ct_powmod(uint32_t* r, const uint32_t* base, const uint32_t* exp, size_t expWords,
+	const uint32_t* m, size_t n)
+{
+	std::vector<uint32_t> result(n, 0), one(n, 0), power(base, base + n), product(n);
+
+	/* Reduce 1 by m so that m == 1 gives 0 like every other result. */
+	one[0] = 1;
+	ct_mulmod(result.data(), one.data(), one.data(), m, n);
+
+	/* Square and always multiply, keeping the product only when the bit is
+	 * set, so every exponent of the same length does the same work.
+	 */
+	for (size_t i = 32 * expWords; i > 0; i--)
+	{
+		uint32_t bit = (exp[(i - 1) / 32] >> ((i - 1) % 32)) & 1;
+
+		ct_mulmod(result.data(), result.data(), result.data(), m, n);
+		ct_mulmod(product.data(), result.data(), power.data(), m, n);
+		ct_select(result.data(), product.data(), result.data(), n, bit);
+	}
+
+	for (size_t i = 0; i < n; i++)
+		r[i] = result[i];
+}
@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bigint.hpp"
+
+using namespace std;
+
+/* Usage: difftest.exe [iterations] [seed]
+ *
+ * Cross-checks BigInt against a deliberately simple reference on random
+ * operands. Sizes are drawn at random and also placed on either side of each
+ * algorithm threshold, so that every fast path is exercised next to the path
+ * it replaces. All values cross over as decimal strings, which the reference
+ * produces and parses on its own.
+ */
+
+namespace
+{
+	/* Sign and little endian magnitude, without any cleverness. */
+	struct Reference
+	{
+		bool negative;
+		vector<uint32_t> magnitude;
+
+		Reference() : negative(false) {}
+
+		bool isZero() const
+		{
+			return magnitude.empty();
+		}
+
+		void trim()
+		{
+			while (!magnitude.empty() && magnitude.back() == 0)
+				magnitude.pop_back();
+
+			if (magnitude.empty())
+				negative = false;
+		}
+	};
+
+	int compareMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b)
+	{
+		if (a.size() != b.size())
+			return a.size() < b.size() ? -1 : 1;
+
+		for (size_t i = a.size(); i > 0; i--)
+			if (a[i - 1] != b[i - 1])
+				return a[i - 1] < b[i - 1] ? -1 : 1;
+
+		return 0;
+	}
+
+	vector<uint32_t> addMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b)
+	{
+		vector<uint32_t> sum(max(a.size(), b.size()) + 1, 0);
+		uint64_t carry = 0;
+
+		for (size_t i = 0; i < sum.size(); i++)
+		{
+			carry += i < a.size() ? a[i] : 0;
+			carry += i < b.size() ? b[i] : 0;
+			sum[i] = static_cast<uint32_t>(carry);
+			carry >>= 32;
+		}
+
+		return sum;
+	}
+
+	/* a - b, where a >= b. */
+	vector<uint32_t> subtractMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b)
+	{
+		vector<uint32_t> difference(a);
+		int64_t borrow = 0;
+
+		for (size_t i = 0; i < difference.size(); i++)
+		{
+			int64_t value = static_cast<int64_t>(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+
+			borrow = value < 0;
+			difference[i] = static_cast<uint32_t>(value + (borrow << 32));
+		}
+
+		return difference;
+	}
+
+	Reference add(const Reference& a, const Reference& b)
+	{
+		Reference sum;
+
+		if (a.negative == b.negative)
+		{
+			sum.negative = a.negative;
+			sum.magnitude = addMagnitude(a.magnitude, b.magnitude);
+		}
+		else if (compareMagnitude(a.magnitude, b.magnitude) >= 0)
+		{
+			sum.negative = a.negative;
+			sum.magnitude = subtractMagnitude(a.magnitude, b.magnitude);
+		}
+		else
+		{
+			sum.negative = b.negative;
+			sum.magnitude = subtractMagnitude(b.magnitude, a.magnitude);
+		}
+
+		sum.trim();
+		return sum;
+	}
+
+	Reference negated(Reference a)
+	{
+		a.negative = !a.negative;
+		a.trim();
+		return a;
+	}
+
+	Reference multiply(const Reference& a, const Reference& b)
+	{
+		Reference product;
+
+		product.negative = a.negative != b.negative;
+		product.magnitude.assign(a.magnitude.size() + b.magnitude.size(), 0);
+
+		for (size_t i = 0; i < a.magnitude.size(); i++)
+			for (size_t j = 0; j < b.magnitude.size(); j++)
+			{
+				uint64_t carry = static_cast<uint64_t>(a.magnitude[i]) * b.magnitude[j];
+
+				for (size_t k = i + j; carry != 0; k++)
+				{
+					carry += product.magnitude[k];
+					product.magnitude[k] = static_cast<uint32_t>(carry);
+					carry >>= 32;
+				}
+			}
+
+		product.trim();
+		return product;
+	}
+
+	/* Truncating division of magnitudes, one bit at a time. */
+	void divideMagnitude(const vector<uint32_t>& a, const vector<uint32_t>& b,
+		vector<uint32_t>& quotient, vector<uint32_t>& remainder)
+	{
+		quotient.assign(a.size(), 0);
+		remainder.clear();
+
+		for (size_t i = 32 * a.size(); i > 0; i--)
+		{
+			uint32_t bit = (a[(i - 1) / 32] >> ((i - 1) % 32)) & 1;
+
+			/* Shift in the next bit the slow way: double and add. */
+			remainder = addMagnitude(remainder, remainder);
+			if (bit)
+				remainder = addMagnitude(remainder, vector<uint32_t>(1, 1));
+
+			while (!remainder.empty() && remainder.back() == 0)
+				remainder.pop_back();
+
+			if (compareMagnitude(remainder, b) >= 0)
+			{
+				remainder = subtractMagnitude(remainder, b);
+				while (!remainder.empty() && remainder.back() == 0)
+					remainder.pop_back();
+
+				quotient[(i - 1) / 32] |= 1u << ((i - 1) % 32);
+			}
+		}
+	}
+
+	/* Floored division with the remainder taking the sign of the divisor. */
+	void divide(const Reference& a, const Reference& b, Reference& quotient, Reference& remainder)
+	{
+		divideMagnitude(a.magnitude, b.magnitude, quotient.magnitude, remainder.magnitude);
+
+		quotient.negative = a.negative != b.negative;
+		remainder.negative = a.negative;
+		quotient.trim();
+		remainder.trim();
+
+		if (a.negative != b.negative && !remainder.isZero())
+		{
+			Reference one;
+			one.magnitude.push_back(1);
+
+			quotient = add(quotient, negated(one));
+
+			remainder.magnitude = subtractMagnitude(b.magnitude, remainder.magnitude);
+			remainder.negative = b.negative;
+			remainder.trim();
+		}
+		else if (!remainder.isZero())
+			remainder.negative = b.negative;
+	}
+
+	Reference fromWord(uint32_t word)
+	{
+		Reference value;
+		value.magnitude.push_back(word);
+		value.trim();
+		return value;
+	}
+
+	Reference shiftLeft(Reference a, uint32_t bits)
+	{
+		for (uint32_t i = 0; i < bits; i++)
+			a.magnitude = addMagnitude(a.magnitude, a.magnitude);
+
+		a.trim();
+		return a;
+	}
+
+	Reference shiftRight(const Reference& a, uint32_t bits)
+	{
+		Reference quotient, remainder, divisor(shiftLeft(fromWord(1), bits));
+
+		divideMagnitude(a.magnitude, divisor.magnitude, quotient.magnitude, remainder.magnitude);
+		quotient.negative = a.negative;
+		quotient.trim();
+
+		return quotient;
+	}
+
+	string toDecimal(const Reference& a)
+	{
+		if (a.isZero())
+			return "0";
+
+		string digits;
+		vector<uint32_t> magnitude(a.magnitude);
+
+		/* Peel off one decimal digit at a time by short division. */
+		while (!magnitude.empty())
+		{
+			uint64_t remainder = 0;
+
+			for (size_t i = magnitude.size(); i > 0; i--)
+			{
+				remainder = (remainder << 32) + magnitude[i - 1];
+				magnitude[i - 1] = static_cast<uint32_t>(remainder / 10);
+				remainder %= 10;
+			}
+
+			digits.push_back(static_cast<char>('0' + remainder));
+
+			while (!magnitude.empty() && magnitude.back() == 0)
+				magnitude.pop_back();
+		}
+
+		if (a.negative)
+			digits.push_back('-');
+
+		reverse(digits.begin(), digits.end());
+		return digits;
+	}
+
+	Reference fromDecimal(const string& decimal)
+	{
+		Reference value;
+		size_t begin = decimal[0] == '-' ? 1 : 0;
+
+		for (size_t i = begin; i < decimal.size(); i++)
+		{
+			value = multiply(value, fromWord(10));
+			value = add(value, fromWord(static_cast<uint32_t>(decimal[i] - '0')));
+		}
+
+		value.negative = begin == 1;
+		value.trim();
+		return value;
+	}
+
+	mt19937 generator;
+
+	Reference randomReference(size_t words)
+	{
+		Reference value;
+
+		for (size_t i = 0; i < words; i++)
+			value.magnitude.push_back(generator());
+
+		/* Sparse and saturated words find carry and borrow bugs. */
+		switch (generator() % 4)
+		{
+		case 0:
+			for (auto& word : value.magnitude)
+				word = generator() % 3 == 0 ? 0xFFFFFFFF : 0;
+			break;
+		case 1:
+			if (!value.magnitude.empty())
+				value.magnitude.back() |= 0x80000000;
+			break;
+		}
+
+		value.negative = generator() % 2 == 0;
+		value.trim();
+		return value;
+	}
+
+	string randomDecimal(size_t digits)
+	{
+		string decimal(generator() % 2 == 0 ? "-" : "");
+
+		decimal.push_back(static_cast<char>('1' + generator() % 9));
+		for (size_t i = 1; i < digits; i++)
+			decimal.push_back(static_cast<char>('0' + generator() % 10));
+
+		return decimal;
+	}
+
+	size_t failures = 0;
+
+	void check(const string& what, const string& expected, const string& actual)
+	{
+		if (expected != actual)
+		{
+			cout << what << ": expected " << expected << ", got " << actual << endl;
+			failures++;
+		}
+	}
+
+	size_t randomSize(const vector<size_t>& interesting)
+	{
+		if (generator() % 2 == 0)
+			return 1 + generator() % 80;
+
+		size_t size = interesting[generator() % interesting.size()];
+		return max<size_t>(1, size + generator() % 3 - 1);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	size_t iterations = argc > 1 ? strtoull(argv[1], nullptr, 10) : 200;
+	uint32_t seed = argc > 2 ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : 1;
+
+	generator.seed(seed);
+
+	size_t karatsuba = BigInt::karatsubaThreshold;
+	vector<size_t> wordSizes { 1, 2, karatsuba, karatsuba + 1, 2 * karatsuba, 2 * karatsuba + 1, 4 * karatsuba };
+	vector<size_t> digitSizes { 1, 9, 10, BigInt::parseThreshold, 2 * BigInt::parseThreshold };
+
+	for (size_t iteration = 0; iteration < iterations; iteration++)
+	{
+		Reference a(randomReference(randomSize(wordSizes)));
+		Reference b(randomReference(generator() % 4 == 0 ? a.magnitude.size() / 2 + 1 : randomSize(wordSizes)));
+		string decimalA(toDecimal(a)), decimalB(toDecimal(b));
+		BigInt bigA(decimalA), bigB(decimalB);
+
+		uint32_t word = generator() % 2 ? generator() : generator() % 16;
+		uint32_t shift = generator() % 100;
+
+		check("to_string", decimalA, string(bigA));
+		check("add", toDecimal(add(a, b)), string(bigA + bigB));
+		check("sub", toDecimal(add(a, negated(b))), string(bigA - bigB));
+		check("mul", toDecimal(multiply(a, b)), string(bigA * bigB));
+		check("mul_word", toDecimal(multiply(a, fromWord(word))), string(bigA * word));
+		check("lshift", toDecimal(shiftLeft(a, shift)), string(bigA << shift));
+		check("rshift", toDecimal(shiftRight(a, shift)), string(bigA >> shift));
+		check("compare", to_string(compareMagnitude(a.magnitude, b.magnitude) == 0 && a.negative == b.negative),
+			to_string(bigA == bigB));
+
+		bool less = a.negative != b.negative ? a.negative
+			: (a.negative ? compareMagnitude(b.magnitude, a.magnitude) : compareMagnitude(a.magnitude, b.magnitude)) < 0;
+		check("less", to_string(less), to_string(bigA < bigB));
+
+		if (!b.isZero())
+		{
+			Reference quotient, remainder;
+			divide(a, b, quotient, remainder);
+
+			check("div", toDecimal(quotient), string(bigA / bigB));
+			check("mod", toDecimal(remainder), string(bigA % bigB));
+			check("divexact", decimalA, string((bigA * bigB).divexact(bigB)));
+		}
+
+		if (word != 0)
+		{
+			Reference quotient, remainder;
+			divideMagnitude(a.magnitude, vector<uint32_t>(1, word), quotient.magnitude, remainder.magnitude);
+			quotient.negative = a.negative;
+			quotient.trim();
+			remainder.trim();
+
+			check("div_word", toDecimal(quotient), string(bigA / word));
+			check("mod_word", toDecimal(remainder), to_string(bigA % word));
+		}
+
+		string decimal(randomDecimal(randomSize(digitSizes)));
+		check("parse", toDecimal(fromDecimal(decimal)), string(BigInt(decimal)));
+	}
+
+	cout << iterations << " iterations with seed " << seed << ": " << failures << " failures" << endl;
+
+	return failures == 0 ? 0 : 1;
+}
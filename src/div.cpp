@@ -2,6 +2,60 @@
 #include <stdexcept>
 
 #include "bigint.hpp"
+#include "counters.hpp"
+
+namespace
+{
+	/* The inverse of an odd word modulo 2^32. Starting from the word itself
+	 * is right to 3 bits, and each Newton step doubles that.
+	 */
+	uint32_t inverseWord(const uint32_t odd)
+	{
+		uint32_t inverse = odd;
+
+		for (size_t i = 0; i < 4; i++)
+			inverse *= 2 - odd * inverse;
+
+		return inverse;
+	}
+
+	/* q = a / b modulo 2^(32 count), one word at a time: each quotient word is
+	 * the one that clears the lowest remaining word of a, which is then
+	 * subtracted out. b is odd and an >= count. Only the low count words of
+	 * the running remainder are ever needed.
+	 */
+	void henselDivide(uint32_t* q, size_t count, const uint32_t* a, const uint32_t* b, size_t bn)
+	{
+		std::vector<uint32_t> remainder(a, a + count);
+		const uint32_t inverse = inverseWord(b[0]);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			const uint32_t word = remainder[i] * inverse;
+			const size_t end = std::min(bn, count - i);
+			uint64_t carry = 0;
+
+			q[i] = word;
+
+			for (size_t j = 0; j < end; j++)
+			{
+				uint64_t product = static_cast<uint64_t>(word) * b[j] + carry;
+				uint32_t low = static_cast<uint32_t>(product), value = remainder[i + j];
+
+				remainder[i + j] = value - low;
+				carry = (product >> 32) + (value < low);
+			}
+
+			for (size_t j = i + end; carry != 0 && j < count; j++)
+			{
+				uint32_t value = remainder[j];
+
+				remainder[j] = static_cast<uint32_t>(value - carry);
+				carry = value < carry;
+			}
+		}
+	}
+}
 
 BigInt BigInt::operator/(const BigInt& that) const
 {
@@ -10,23 +64,44 @@ BigInt BigInt::operator/(const BigInt& that) const
 	return copy;
 }
 
+BigInt BigInt::operator/(const uint32_t that) const
+{
+	BigInt copy(*this);
+	copy /= that;
+	return copy;
+}
+
 BigInt& BigInt::operator/=(const BigInt& that)
 {
+	BIGINT_TIME(Counter::Divide, words.size() + that.words.size());
+
 	if (that.isZero())
 		throw std::invalid_argument("division by zero");
-	else if (positive && *this < that)
-		return *this = zero;
 
 	bool signsDiffer = positive != that.positive;
 
 	BigInt dividend(*this);
 	BigInt divisor(that);
 
+	dividend.positive = divisor.positive = true;
+
+	/* If |this| < |that|, the quotient rounds down to either 0 or -1. */
+	if (dividend < divisor)
+	{
+		bool negative = signsDiffer && !isZero();
+
+		*this = zero;
+		if (negative)
+			*this -= one;
+
+		return *this;
+	}
+
 	size_t shift = dividend.size() - divisor.size();
 
 	std::vector<bool> binaryDigits;
-
-	dividend.positive = divisor.positive = true;
+	binaryDigits.reserve(shift + 1);
+	BIGINT_ALLOCATION(Counter::Divide);
 
 	divisor <<= shift;
 	while (divisor > dividend)
@@ -71,12 +146,14 @@ BigInt& BigInt::operator/=(const BigInt& that)
 
 BigInt& BigInt::operator/=(const uint32_t that)
 {
+	BIGINT_TIME(Counter::DivideWord, words.size());
+
 	if (that == 0)
 		throw std::invalid_argument("division by zero");
 
 	uint64_t remainder = 0;
 
-	for (auto word = words.rbegin(); word != words.rend(); ++word)
+	for (auto word = words.rbegin(), last = words.rend(); word != last; ++word)
 	{
 		remainder = (remainder << 32) + static_cast<uint64_t>(*word);
 		*word = static_cast<uint32_t>(remainder / that);
@@ -84,5 +161,245 @@ BigInt& BigInt::operator/=(const uint32_t that)
 	}
 	trim();
 
+	if (isZero())
+		positive = true;
+
+	return *this;
+}
+
+BigInt BigInt::operator/(const int that) const
+{
+	BigInt copy(*this);
+	copy /= that;
+	return copy;
+}
+
+BigInt BigInt::operator/(const int64_t that) const
+{
+	BigInt copy(*this);
+	copy /= that;
+	return copy;
+}
+
+BigInt BigInt::operator/(const uint64_t that) const
+{
+	BigInt copy(*this);
+	copy /= that;
+	return copy;
+}
+
+BigInt& BigInt::operator/=(const int that)
+{
+	return *this /= static_cast<int64_t>(that);
+}
+
+BigInt& BigInt::operator/=(const int64_t that)
+{
+	const bool signsDiffer = isNegative() != (that < 0);
+
+	/* Floored, as BigInt's own division is, so a truncated quotient with a
+	 * remainder moves one further down.
+	 */
+	if (divideScalar(that < 0, magnitudeOf(that)) != 0 && signsDiffer)
+		*this -= 1;
+
 	return *this;
-}
\ No newline at end of file
+}
+
+BigInt& BigInt::operator/=(const uint64_t that)
+{
+	divideScalar(false, that);
+	return *this;
+}
+
+uint64_t BigInt::divideScalar(const bool negative, const uint64_t magnitude)
+{
+	if (magnitude == 0)
+		throw std::invalid_argument("division by zero");
+
+	BIGINT_TIME(Counter::DivideWord, words.size());
+
+	uint64_t remainder = 0;
+
+	if (magnitude >> 32 == 0)
+	{
+		for (auto word = words.rbegin(), last = words.rend(); word != last; ++word)
+		{
+			remainder = (remainder << 32) + *word;
+			*word = static_cast<uint32_t>(remainder / magnitude);
+			remainder %= magnitude;
+		}
+	}
+	else
+	{
+		unsigned __int128 wide = 0;
+
+		for (auto word = words.rbegin(), last = words.rend(); word != last; ++word)
+		{
+			wide = (wide << 32) + *word;
+			*word = static_cast<uint32_t>(wide / magnitude);
+			wide %= magnitude;
+		}
+
+		remainder = static_cast<uint64_t>(wide);
+	}
+
+	trim();
+
+	if (isZero())
+		positive = true;
+
+	if (negative)
+		negate();
+
+	return remainder;
+}
+
+BigInt BigInt::divexact(const BigInt& that) const
+{
+	BIGINT_TIME(Counter::Divide, words.size() + that.words.size());
+
+	if (that.isZero())
+		throw std::invalid_argument("division by zero");
+
+	BigInt dividend(*this), divisor(that);
+	dividend.positive = divisor.positive = true;
+
+	/* Dividing out the divisor's factors of two leaves it odd, and so
+	 * invertible modulo any power of two.
+	 */
+	const uint32_t shift = static_cast<uint32_t>(divisor.countTrailingZeros());
+	dividend >>= shift;
+	divisor >>= shift;
+
+	BigInt quotient;
+
+	if (divisor.words.size() == 1)
+		quotient = dividend.divexact(divisor.words[0]);
+	else if (dividend.words.size() >= divisor.words.size())
+	{
+		const size_t count = dividend.words.size() - divisor.words.size() + 1;
+
+		if (count < karatsubaThreshold || divisor.words.size() < karatsubaThreshold)
+		{
+			quotient.words.resize(count);
+			henselDivide(quotient.words.data(), count, dividend.words.data(), divisor.words.data(),
+				divisor.words.size());
+		}
+		else
+		{
+			/* Newton's iteration x = x (2 - b x) doubles the words of the
+			 * inverse that are right each time, so the whole inverse costs
+			 * about as much as the one multiplication that uses it.
+			 */
+			BigInt inverse(inverseWord(divisor.words[0]));
+
+			for (size_t precision = 1; precision < count;)
+			{
+				precision = std::min(2 * precision, count);
+
+				BigInt low(divisor);
+				low.truncateWords(precision);
+
+				BigInt error(low * inverse);
+				error.truncateWords(precision);
+				error -= 1u;
+
+				BigInt correction(inverse * error);
+				correction.truncateWords(precision);
+
+				inverse -= correction;
+				if (inverse.isNegative())
+					inverse += one << static_cast<uint32_t>(32 * precision);
+			}
+
+			dividend.truncateWords(count);
+			quotient = dividend * inverse;
+		}
+
+		quotient.truncateWords(count);
+		quotient.trim();
+	}
+
+	if (positive != that.positive)
+		quotient.negate();
+
+	return quotient;
+}
+
+BigInt BigInt::divexact(const uint32_t that) const
+{
+	BIGINT_TIME(Counter::DivideWord, words.size());
+
+	if (that == 0)
+		throw std::invalid_argument("division by zero");
+
+	const uint32_t shift = __builtin_ctz(that), divisor = that >> shift;
+	const uint32_t inverse = inverseWord(divisor);
+
+	BigInt quotient(*this >> shift);
+	uint64_t carry = 0;
+
+	/* The single word case of henselDivide, where the carry out of each word
+	 * is the high half of quotient word times divisor plus the borrow.
+	 */
+	for (auto& word : quotient.words)
+	{
+		uint32_t value = word, low = static_cast<uint32_t>(value - carry);
+		uint32_t borrow = value < carry;
+
+		word = low * inverse;
+		carry = (static_cast<uint64_t>(word) * divisor >> 32) + borrow;
+	}
+
+	quotient.trim();
+
+	if (quotient.isZero())
+		quotient.positive = true;
+
+	return quotient;
+}
+
+bool BigInt::divisible(const BigInt& that) const
+{
+	if (that.isZero())
+		return isZero();
+
+	if (that.words.size() == 1)
+		return divisible(that.words[0]);
+
+	if (countTrailingZeros() < that.countTrailingZeros() && !isZero())
+		return false;
+
+	BigInt quotient(divexact(that));
+	quotient *= that;
+
+	return quotient == *this;
+}
+
+bool BigInt::divisible(const uint32_t that) const
+{
+	if (that == 0)
+		return isZero();
+
+	const uint32_t shift = __builtin_ctz(that), divisor = that >> shift;
+
+	if (!isZero() && countTrailingZeros() < shift)
+		return false;
+
+	/* Running the Hensel division over every word leaves this - carry 2^(32n)
+	 * = divisor q, and the carry is less than the divisor, so it is zero
+	 * exactly when the odd divisor divides this.
+	 */
+	const uint32_t inverse = inverseWord(divisor);
+	uint64_t carry = 0;
+
+	for (auto word : words)
+	{
+		uint32_t low = static_cast<uint32_t>(word - carry), borrow = word < carry;
+
+		carry = (static_cast<uint64_t>(low * inverse) * divisor >> 32) + borrow;
+	}
+
+	return carry == 0;
+}
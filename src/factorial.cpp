@@ -0,0 +1,139 @@
+#include "bigint.hpp"
+
+namespace
+{
+	std::vector<uint32_t> primesUpTo(uint32_t n)
+	{
+		std::vector<uint32_t> primes;
+
+		if (n < 2)
+			return primes;
+
+		std::vector<bool> composite(n + 1, false);
+
+		for (uint64_t i = 2; i <= n; i++)
+		{
+			if (composite[i])
+				continue;
+
+			primes.push_back(static_cast<uint32_t>(i));
+
+			for (uint64_t j = i * i; j <= n; j += i)
+				composite[j] = true;
+		}
+
+		return primes;
+	}
+
+	/* Multiply the factors together, packing as many as fit into each word
+	 * first so the product tree has fewer (and fuller) leaves.
+	 */
+	BigInt packedProduct(const std::vector<uint32_t>& factors)
+	{
+		std::vector<BigInt> leaves;
+		uint64_t word = 1;
+
+		for (auto factor : factors)
+		{
+			if (word * factor > 0xFFFFFFFFull)
+			{
+				leaves.push_back(BigInt(static_cast<uint32_t>(word)));
+				word = 1;
+			}
+
+			word *= factor;
+		}
+
+		if (word != 1)
+			leaves.push_back(BigInt(static_cast<uint32_t>(word)));
+
+		return productOf(leaves);
+	}
+
+	/* Given the exponent of each odd prime and the exponent of two, build
+	 *
+	 *   2^twos * prod p^e
+	 *
+	 * by walking the exponent bits from the top: square the partial result,
+	 * then multiply in every prime whose exponent has the current bit set.
+	 */
+	BigInt fromFactorization(const std::vector<uint32_t>& primes,
+		const std::vector<uint32_t>& exponents, uint32_t twos)
+	{
+		uint32_t maxExponent = 0;
+		for (auto exponent : exponents)
+			if (exponent > maxExponent)
+				maxExponent = exponent;
+
+		uint32_t bit = 1;
+		while (bit <= maxExponent / 2)
+			bit <<= 1;
+
+		BigInt result(1);
+
+		for (; maxExponent != 0 && bit != 0; bit >>= 1)
+		{
+			std::vector<uint32_t> factors;
+
+			for (size_t i = 0; i < primes.size(); i++)
+				if (exponents[i] & bit)
+					factors.push_back(primes[i]);
+
+			result *= result;
+			result *= packedProduct(factors);
+		}
+
+		return result << twos;
+	}
+
+	uint32_t legendre(uint32_t n, uint32_t p)
+	{
+		uint32_t exponent = 0;
+
+		for (uint64_t power = p; power <= n; power *= p)
+			exponent += static_cast<uint32_t>(n / power);
+
+		return exponent;
+	}
+}
+
+BigInt factorial(const uint32_t n)
+{
+	std::vector<uint32_t> primes(primesUpTo(n));
+	std::vector<uint32_t> exponents;
+	uint32_t twos = legendre(n, 2);
+
+	if (!primes.empty())
+		primes.erase(primes.begin());
+
+	for (auto p : primes)
+		exponents.push_back(legendre(n, p));
+
+	return fromFactorization(primes, exponents, twos);
+}
+
+BigInt binomial(const uint32_t n, const uint32_t k)
+{
+	if (k > n)
+		return BigInt(0);
+
+	/* By Legendre's formula, the exponent of p in n! / (k! (n - k)!) is the
+	 * difference of the exponents in each factorial.
+	 */
+	std::vector<uint32_t> primes(primesUpTo(n));
+	std::vector<uint32_t> exponents;
+	uint32_t twos = legendre(n, 2) - legendre(k, 2) - legendre(n - k, 2);
+
+	if (!primes.empty())
+		primes.erase(primes.begin());
+
+	for (auto p : primes)
+		exponents.push_back(legendre(n, p) - legendre(k, p) - legendre(n - k, p));
+
+	return fromFactorization(primes, exponents, twos);
+}
+
+BigInt primorial(const uint32_t n)
+{
+	return packedProduct(primesUpTo(n));
+}
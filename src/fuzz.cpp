@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include "bigint.hpp"
+
+/* libFuzzer entry point for parsing and arithmetic.
+ *
+ * The whole input is first handed to the string constructor, which must
+ * either throw std::invalid_argument or produce a value that prints back as
+ * the canonical form of the input. The input is then split in two, each
+ * half is mapped onto decimal digits, and the operators are checked against
+ * identities that relate them to each other.
+ */
+
+namespace
+{
+	void require(bool condition)
+	{
+		if (!condition)
+			abort();
+	}
+
+	std::string canonical(const std::string& str)
+	{
+		bool negative = str[0] == '-';
+		size_t first = str.find_first_not_of('0', negative ? 1 : 0);
+
+		if (first == std::string::npos)
+			return "0";
+
+		return (negative ? "-" : "") + str.substr(first);
+	}
+
+	std::string toDecimal(const uint8_t* data, size_t size)
+	{
+		std::string decimal;
+
+		if (size > 0 && data[0] & 1)
+			decimal.push_back('-');
+
+		for (size_t i = 0; i < size; i++)
+			decimal.push_back(static_cast<char>('0' + data[i] % 10));
+
+		if (decimal.empty() || decimal == "-")
+			decimal.push_back('1');
+
+		return decimal;
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	std::string input(reinterpret_cast<const char*>(data), size);
+
+	try
+	{
+		BigInt parsed(input);
+
+		if (!input.empty())
+			require(static_cast<std::string>(parsed) == canonical(input));
+	}
+	catch (const std::invalid_argument&)
+	{
+	}
+
+	std::string left(toDecimal(data, size / 2)), right(toDecimal(data + size / 2, size - size / 2));
+	BigInt a(canonical(left)), b(canonical(right));
+	uint32_t shift = size > 0 ? data[0] % 97 : 0;
+
+	require(a + b - b == a);
+	require(a - b + b == a);
+	require(a + b == b + a);
+	require(a * b == b * a);
+	require((a << shift) >> shift == a);
+	require((a < b) + (a == b) + (a > b) == 1);
+	require((a & b) + (a | b) == a + b);
+	require((a ^ b) == (a | b) - (a & b));
+	require(~a == -a - BigInt(1));
+
+	if (!b.isZero())
+	{
+		BigInt quotient(a / b), remainder(a % b);
+
+		require(quotient * b + remainder == a);
+		require(remainder.isZero() || remainder.isNegative() == b.isNegative());
+		require(remainder.isNegative() ? remainder > b : remainder < b);
+		require(a * b / b == a);
+	}
+
+	return 0;
+}
+
+#ifdef BIGINT_FUZZ_MAIN
+#include <fstream>
+#include <iterator>
+
+/* Without libFuzzer, replay the inputs named on the command line. */
+int main(int argc, char** argv)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		std::ifstream file(argv[i], std::ios::binary);
+		std::string input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+	}
+
+	return 0;
+}
+#endif
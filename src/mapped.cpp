@@ -0,0 +1,264 @@
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped.hpp"
+
+namespace
+{
+	const char magic[8] = { 'B', 'I', 'G', 'I', 'N', 'T', '\0', '\1' };
+	const uint32_t version = 1;
+
+	static_assert(sizeof(BigIntFileHeader) == 24, "the file header must be 24 bytes");
+
+	/* The words are used in place, so the host must share the file's byte
+	 * order.
+	 */
+	bool littleEndian()
+	{
+		const uint32_t one = 1;
+		return *reinterpret_cast<const unsigned char*>(&one) == 1;
+	}
+
+	void requireLittleEndian()
+	{
+		if (!littleEndian())
+			throw std::runtime_error("BigInt files are only supported on little endian hosts");
+	}
+
+	bool writeAll(int fd, const void* data, size_t length)
+	{
+		const char* bytes = static_cast<const char*>(data);
+
+		while (length > 0)
+		{
+			ssize_t written = write(fd, bytes, length);
+			if (written < 0)
+				return false;
+
+			bytes += written;
+			length -= static_cast<size_t>(written);
+		}
+
+		return true;
+	}
+}
+
+BigIntFileHeader::BigIntFileHeader(bool negative, uint64_t count)
+	: version(::version), flags(negative ? negativeFlag : 0), count(count)
+{
+	std::memcpy(magic, ::magic, sizeof(magic));
+}
+
+bool BigIntFileHeader::valid(size_t fileLength) const
+{
+	return std::memcmp(magic, ::magic, sizeof(magic)) == 0 && version == ::version && count != 0
+		&& fileLength >= sizeof(*this)
+		&& count <= (fileLength - sizeof(*this)) / sizeof(uint32_t);
+}
+
+int createReplacement(const std::string& path, std::string& temporary)
+{
+	static std::atomic<unsigned> next(0);
+	int fd = -1;
+
+	/* Created exclusively with mode 0666, so the kernel applies the umask as
+	 * it would to path itself; the names only need to be unlikely to clash.
+	 */
+	for (unsigned attempt = 0; attempt < 100 && fd < 0; attempt++)
+	{
+		temporary = path + "." + std::to_string(getpid()) + "." + std::to_string(next++);
+		fd = open(temporary.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+
+		if (fd < 0 && errno != EEXIST)
+			return -1;
+	}
+
+	struct stat status;
+
+	if (fd >= 0 && stat(path.c_str(), &status) == 0 && fchmod(fd, status.st_mode & 0777) != 0)
+	{
+		close(fd);
+		unlink(temporary.c_str());
+		return -1;
+	}
+
+	return fd;
+}
+
+void BigInt::save(const std::string& path) const
+{
+	requireLittleEndian();
+
+	/* Truncating path in place would pull the words out from under any
+	 * mapping of it, which may be where this value's own words are.
+	 */
+	std::string temporary;
+
+	int fd = createReplacement(path, temporary);
+	if (fd < 0)
+		throw std::runtime_error("could not write " + path);
+
+	BigIntFileHeader header(!positive, words.size());
+
+	bool written = writeAll(fd, &header, sizeof(header))
+		&& writeAll(fd, words.data(), words.size() * sizeof(uint32_t));
+
+	if (close(fd) != 0 || !written || std::rename(temporary.c_str(), path.c_str()) != 0)
+	{
+		unlink(temporary.c_str());
+		throw std::runtime_error("could not write " + path);
+	}
+}
+
+MappedBigInt BigInt::mapFile(const std::string& path)
+{
+	requireLittleEndian();
+
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw std::runtime_error("could not open " + path);
+
+	struct stat status;
+	if (fstat(fd, &status) != 0)
+	{
+		close(fd);
+		throw std::runtime_error("could not stat " + path);
+	}
+
+	size_t length = static_cast<size_t>(status.st_size);
+	if (length < sizeof(BigIntFileHeader))
+	{
+		close(fd);
+		throw std::invalid_argument("invalid BigInt file " + path);
+	}
+
+	void* mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (mapping == MAP_FAILED)
+		throw std::runtime_error("could not map " + path);
+
+	/* The mapped object owns the mapping from here on, so it is unmapped
+	 * even if the header turns out to be invalid.
+	 */
+	MappedBigInt mapped(mapping, length);
+
+	mapped.device = static_cast<uint64_t>(status.st_dev);
+	mapped.inode = static_cast<uint64_t>(status.st_ino);
+
+	return mapped;
+}
+
+MappedBigInt::MappedBigInt(void* mapping, size_t mappingLength) : positive(true), device(0), inode(0)
+{
+	const char* bytes = static_cast<const char*>(mapping);
+	BigIntFileHeader header;
+
+	std::memcpy(&header, bytes, sizeof(header));
+
+	if (!header.valid(mappingLength))
+	{
+		unmap(mapping, mappingLength);
+		throw std::invalid_argument("invalid BigInt file");
+	}
+
+	words = SharedWords::borrow(reinterpret_cast<const uint32_t*>(bytes + sizeof(header)),
+		static_cast<size_t>(header.count), mapping, mappingLength, unmap);
+	positive = (header.flags & BigIntFileHeader::negativeFlag) == 0;
+
+	/* Huge values are usually read front to back. */
+	madvise(mapping, mappingLength, MADV_SEQUENTIAL);
+}
+
+MappedBigInt::MappedBigInt(MappedBigInt&& that)
+	: words(std::move(that.words)), positive(that.positive), device(that.device), inode(that.inode)
+{
+}
+
+MappedBigInt& MappedBigInt::operator=(MappedBigInt&& that)
+{
+	words = std::move(that.words);
+	positive = that.positive;
+	device = that.device;
+	inode = that.inode;
+
+	return *this;
+}
+
+void MappedBigInt::unmap(void* mapping, size_t mappingLength)
+{
+	munmap(mapping, mappingLength);
+}
+
+MappedBigInt::operator BigInt() const
+{
+	/* Trimmed here rather than by trim(), whose non-const access would copy
+	 * the words.
+	 */
+	SharedWords magnitude(words);
+
+	while (magnitude.size() > 1 && words[magnitude.size() - 1] == 0)
+		magnitude.pop_back();
+
+	const bool zero = magnitude.size() == 1 && words[0] == 0;
+
+	return BigInt(std::move(magnitude), positive || zero);
+}
+
+const uint32_t* MappedBigInt::data() const
+{
+	return words.data();
+}
+
+size_t MappedBigInt::length() const
+{
+	return words.size();
+}
+
+bool MappedBigInt::isZero() const
+{
+	for (size_t i = 0; i < words.size(); i++)
+		if (words[i] != 0)
+			return false;
+
+	return true;
+}
+
+bool MappedBigInt::isPositive() const
+{
+	return positive;
+}
+
+bool MappedBigInt::isNegative() const
+{
+	return !positive;
+}
+
+size_t MappedBigInt::size() const
+{
+	size_t top = words.size();
+	while (top > 0 && words[top - 1] == 0)
+		top--;
+
+	if (top == 0)
+		return 0;
+
+	return 32 * top - __builtin_clz(words[top - 1]);
+}
+
+bool MappedBigInt::isFile(const std::string& path) const
+{
+	struct stat status;
+
+	return stat(path.c_str(), &status) == 0 && static_cast<uint64_t>(status.st_dev) == device
+		&& static_cast<uint64_t>(status.st_ino) == inode;
+}
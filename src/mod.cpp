@@ -1,4 +1,7 @@
+#include <stdexcept>
+
 #include "bigint.hpp"
+#include "counters.hpp"
 
 BigInt BigInt::operator%(const BigInt& that) const
 {
@@ -11,8 +14,11 @@ uint32_t BigInt::operator%(const uint32_t that) const
 {
 	uint64_t remainder = 0;
 
-	if (*this < BigInt(that))
-		return words[0];
+	if (that == 0)
+		throw std::invalid_argument("division by zero");
+
+	if (words.size() == 1)
+		return words[0] % that;
 
 	for (auto word = words.crbegin(); word != words.crend(); ++word)
 	{
@@ -24,18 +30,26 @@ uint32_t BigInt::operator%(const uint32_t that) const
 
 BigInt& BigInt::operator%=(const BigInt& that)
 {
+	BIGINT_TIME(Counter::Modulo, words.size() + that.words.size());
+
+	if (that.isZero())
+		throw std::invalid_argument("division by zero");
+
 	bool wasPositive = positive;
 	positive = true;
 
 	*this %= that.words;
-	std::cout << (std::string)(*this) << std::endl;
-	
+
+	if (isZero())
+		return *this;
+
+	/* The remainder takes the sign of the divisor, so when the signs differ
+	 * we have to step |this| back from |that|.
+	 */
 	if (wasPositive != that.positive)
 	{
-		*this = that + *this;
-
-		if (!that.positive)
-			positive = false;
+		*this = BigInt(that.words) - *this;
+		positive = that.positive;
 	}
 	else
 		positive = wasPositive;
@@ -46,6 +60,10 @@ BigInt& BigInt::operator%=(const BigInt& that)
 BigInt& BigInt::operator%=(const BigInt::Words& that)
 {
 	BigInt divisor(that);
+
+	if (*this < divisor)
+		return *this;
+
 	size_t shift = size() - divisor.size();
 
 	divisor <<= shift;
@@ -70,3 +88,69 @@ BigInt& BigInt::operator%=(const BigInt::Words& that)
 	return *this;
 }
 
+int BigInt::operator%(const int that) const
+{
+	return static_cast<int>(*this % static_cast<int64_t>(that));
+}
+
+int64_t BigInt::operator%(const int64_t that) const
+{
+	if (that == 0)
+		throw std::invalid_argument("division by zero");
+
+	/* Floored, as BigInt's own remainder is: a non-zero remainder takes the
+	 * sign of the divisor.
+	 */
+	int64_t remainder = static_cast<int64_t>(remainderScalar(magnitudeOf(that)));
+
+	if (!positive)
+		remainder = -remainder;
+
+	if (remainder != 0 && (remainder < 0) != (that < 0))
+		remainder += that;
+
+	return remainder;
+}
+
+uint64_t BigInt::operator%(const uint64_t that) const
+{
+	return remainderScalar(that);
+}
+
+BigInt& BigInt::operator%=(const int that)
+{
+	return *this %= static_cast<int64_t>(that);
+}
+
+BigInt& BigInt::operator%=(const uint32_t that)
+{
+	assignScalar(false, *this % that);
+	return *this;
+}
+
+BigInt& BigInt::operator%=(const int64_t that)
+{
+	int64_t remainder = *this % that;
+
+	assignScalar(remainder < 0, magnitudeOf(remainder));
+	return *this;
+}
+
+BigInt& BigInt::operator%=(const uint64_t that)
+{
+	assignScalar(false, remainderScalar(that));
+	return *this;
+}
+
+uint64_t BigInt::remainderScalar(const uint64_t magnitude) const
+{
+	if (magnitude >> 32 == 0)
+		return *this % static_cast<uint32_t>(magnitude);
+
+	unsigned __int128 remainder = 0;
+
+	for (auto word = words.crbegin(); word != words.crend(); ++word)
+		remainder = ((remainder << 32) + *word) % magnitude;
+
+	return static_cast<uint64_t>(remainder);
+}
@@ -1,4 +1,161 @@
+#include <algorithm>
+
 #include "bigint.hpp"
+#include "counters.hpp"
+#include "tuning.hpp"
+
+size_t BigInt::karatsubaThreshold = KARATSUBA_THRESHOLD;
+
+namespace
+{
+	/* r += a, where r is rn words long, returning the carry out of r. */
+	uint32_t addInto(uint32_t* r, size_t rn, const uint32_t* a, size_t an)
+	{
+		uint64_t carry = 0;
+		size_t i = 0;
+
+		for (; i < an && i < rn; i++)
+		{
+			uint64_t sum = static_cast<uint64_t>(r[i]) + a[i] + carry;
+
+			r[i] = static_cast<uint32_t>(sum);
+			carry = sum >> 32;
+		}
+
+		for (; carry != 0 && i < rn; i++)
+		{
+			uint64_t sum = static_cast<uint64_t>(r[i]) + carry;
+
+			r[i] = static_cast<uint32_t>(sum);
+			carry = sum >> 32;
+		}
+
+		return static_cast<uint32_t>(carry);
+	}
+
+	/* r -= a, where r is rn words long and r >= a. */
+	void subtractFrom(uint32_t* r, size_t rn, const uint32_t* a, size_t an)
+	{
+		uint64_t borrow = 0;
+		size_t i = 0;
+
+		for (; i < an; i++)
+		{
+			uint64_t difference = static_cast<uint64_t>(r[i]) - a[i] - borrow;
+
+			r[i] = static_cast<uint32_t>(difference);
+			borrow = difference >> 63;
+		}
+
+		for (; borrow != 0 && i < rn; i++)
+		{
+			uint64_t difference = static_cast<uint64_t>(r[i]) - borrow;
+
+			r[i] = static_cast<uint32_t>(difference);
+			borrow = difference >> 63;
+		}
+	}
+
+	/* r = a * b, where r is an + bn words long. */
+	void schoolbook(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn)
+	{
+		std::fill(r, r + an + bn, 0);
+
+		for (size_t i = 0; i < bn; i++)
+		{
+			uint64_t carry = 0;
+
+			for (size_t j = 0; j < an; j++)
+			{
+				uint64_t product = static_cast<uint64_t>(a[j]) * b[i] + r[i + j] + carry;
+
+				r[i + j] = static_cast<uint32_t>(product);
+				carry = product >> 32;
+			}
+
+			r[i + an] = static_cast<uint32_t>(carry);
+		}
+	}
+
+	/* r = a * b, where r is an + bn words long and does not overlap a or b. */
+	void multiply(uint32_t* r, const uint32_t* a, size_t an, const uint32_t* b, size_t bn)
+	{
+		if (an < bn)
+		{
+			std::swap(a, b);
+			std::swap(an, bn);
+		}
+
+		if (bn < BigInt::karatsubaThreshold || bn < 2)
+		{
+			BIGINT_COUNT(Counter::MultiplySchoolbook, an + bn);
+			schoolbook(r, a, an, b, bn);
+			return;
+		}
+
+		/* Karatsuba wants operands of similar length, so a much longer a is
+		 * multiplied in slices as long as b.
+		 */
+		size_t m = (an + 1) / 2;
+
+		if (bn <= m)
+		{
+			std::vector<uint32_t> slice(2 * bn);
+			BIGINT_ALLOCATION(Counter::MultiplyKaratsuba);
+
+			std::fill(r, r + an + bn, 0);
+
+			for (size_t i = 0; i < an; i += bn)
+			{
+				size_t length = std::min(bn, an - i);
+
+				multiply(slice.data(), a + i, length, b, bn);
+				addInto(r + i, an + bn - i, slice.data(), length + bn);
+			}
+
+			return;
+		}
+
+		/* With B = 2^(32m), a = a1 B + a0 and b = b1 B + b0:
+		 *
+		 *   a b = a1 b1 B^2 + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) B + a0 b0
+		 *
+		 * a0 b0 and a1 b1 go straight into the low and high halves of r. The
+		 * sums are kept to m words plus a carry bit, which is multiplied in
+		 * by hand so that the recursion always shrinks.
+		 */
+		size_t highA = an - m, highB = bn - m;
+
+		BIGINT_COUNT(Counter::MultiplyKaratsuba, an + bn);
+
+		std::vector<uint32_t> sumA(a, a + m);
+		BIGINT_ALLOCATION(Counter::MultiplyKaratsuba);
+		std::vector<uint32_t> sumB(b, b + m);
+		BIGINT_ALLOCATION(Counter::MultiplyKaratsuba);
+		std::vector<uint32_t> middle(2 * m + 2, 0);
+		BIGINT_ALLOCATION(Counter::MultiplyKaratsuba);
+
+		uint32_t carryA = addInto(sumA.data(), m, a + m, highA);
+		uint32_t carryB = addInto(sumB.data(), m, b + m, highB);
+
+		multiply(middle.data(), sumA.data(), m, sumB.data(), m);
+
+		if (carryA)
+			addInto(middle.data() + m, m + 2, sumB.data(), m);
+		if (carryB)
+			addInto(middle.data() + m, m + 2, sumA.data(), m);
+		if (carryA && carryB)
+			addInto(middle.data() + 2 * m, 2, &carryA, 1);
+
+		multiply(r, a, m, b, m);
+		multiply(r + 2 * m, a + m, highA, b + m, highB);
+
+		subtractFrom(middle.data(), middle.size(), r, 2 * m);
+		subtractFrom(middle.data(), middle.size(), r + 2 * m, highA + highB);
+
+		addInto(r + m, an + bn - m, middle.data(), middle.size());
+	}
+}
 
 BigInt BigInt::operator*(const BigInt& that) const
 {
@@ -16,26 +173,27 @@ BigInt BigInt::operator*(const uint32_t that) const
 
 BigInt& BigInt::operator*=(const BigInt& that)
 {
-	if (that.size() == 1)
+	BIGINT_TIME(Counter::Multiply, words.size() + that.words.size());
+
+	if (that.words.size() == 1)
+	{
 		*this *= that.words.back();
+		positive = (positive == that.positive) || isZero();
+	}
 	else
 	{
-		BigInt result;
-		size_t shift = 0;
+		BigInt::Words result(words.size() + that.words.size());
 
-		result.words.reserve(words.size() * that.size());
+		/* Read through a const reference, so that words shared with another
+		 * copy aren't copied only to be replaced.
+		 */
+		const BigInt::Words& factor = words;
 
-		for (auto word : that.words)
-		{
-			BigInt temp(*this * word);
-			temp <<= shift;
-			result += temp.words;
+		multiply(result.data(), factor.data(), factor.size(), that.words.data(), that.words.size());
 
-			shift += 32;
-		}
-		result.positive = (positive == that.positive);
-
-		*this = std::move(result);
+		words = std::move(result);
+		trim();
+		positive = (positive == that.positive) || isZero();
 	}
 
 	return *this;
@@ -43,6 +201,8 @@ BigInt& BigInt::operator*=(const BigInt& that)
 
 BigInt& BigInt::operator*=(const uint32_t that)
 {
+	BIGINT_TIME(Counter::MultiplyWord, words.size());
+
 	uint32_t carry = 0;
 	for (auto& word : words)
 	{
@@ -55,7 +215,86 @@ BigInt& BigInt::operator*=(const uint32_t that)
 	}
 	
 	if (carry != 0)
-		words.push_back(carry);
+		words.resize(words.size() + 1, carry);
+
+	trim();
+
+	if (isZero())
+		positive = true;
+
+	return *this;
+}
+
+BigInt BigInt::operator*(const int that) const
+{
+	BigInt copy(*this);
+	copy *= that;
+	return copy;
+}
+
+BigInt BigInt::operator*(const int64_t that) const
+{
+	BigInt copy(*this);
+	copy *= that;
+	return copy;
+}
+
+BigInt BigInt::operator*(const uint64_t that) const
+{
+	BigInt copy(*this);
+	copy *= that;
+	return copy;
+}
+
+BigInt& BigInt::operator*=(const int that)
+{
+	return *this *= static_cast<int64_t>(that);
+}
+
+BigInt& BigInt::operator*=(const int64_t that)
+{
+	return multiplyScalar(that < 0, magnitudeOf(that));
+}
+
+BigInt& BigInt::operator*=(const uint64_t that)
+{
+	return multiplyScalar(false, that);
+}
+
+BigInt& BigInt::multiplyScalar(const bool negative, const uint64_t magnitude)
+{
+	if (magnitude >> 32 == 0)
+		*this *= static_cast<uint32_t>(magnitude);
+	else
+	{
+		BIGINT_TIME(Counter::MultiplyWord, words.size());
+
+		/* A word times the scalar plus the carry fits in 96 bits. */
+		uint64_t carry = 0;
+		for (auto& word : words)
+		{
+			unsigned __int128 product = static_cast<unsigned __int128>(word) * magnitude + carry;
+
+			word = static_cast<uint32_t>(product);
+			carry = static_cast<uint64_t>(product >> 32);
+		}
+
+		if (carry != 0)
+		{
+			const size_t top = words.size();
+
+			words.resize(top + (carry >> 32 != 0 ? 2 : 1), static_cast<uint32_t>(carry >> 32));
+			words[top] = static_cast<uint32_t>(carry);
+		}
+
+		trim();
+
+		if (isZero())
+			positive = true;
+	}
+
+	if (negative)
+		negate();
 
 	return *this;
 }
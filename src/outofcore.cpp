@@ -0,0 +1,898 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "outofcore.hpp"
+
+size_t diskBlockBytes = 64 << 20;
+
+/* A file mapped in full. New files are created read-write at the given
+ * length. Scratch files are unlinked as soon as they are created, so that
+ * they vanish with the mapping even if the process dies; any other new file
+ * is a temporary beside path that replace() renames over it, and that is
+ * unlinked if it never gets that far.
+ */
+class DiskStore
+{
+public:
+	DiskStore(const std::string& path, size_t length, bool scratch);
+	explicit DiskStore(const std::string& path);
+	~DiskStore();
+
+	DiskStore(const DiskStore&) = delete;
+	DiskStore& operator=(const DiskStore&) = delete;
+
+	char* data() const;
+	size_t length() const;
+
+	/* Write the file out, unmap it, cut it down to length bytes and rename
+	 * it over path.
+	 */
+	void replace(size_t length);
+
+	/* Blocks are converted in memory through BigInt. */
+	static BigInt load(const uint32_t* words, size_t count);
+	static const BigInt::Words& words(const BigInt& value);
+	static BigInt::Words chunks(const BigInt& value);
+
+private:
+	void map(int fd, int protection);
+
+	/* Unlink a temporary that has not replaced its target. */
+	void discard();
+
+	std::string path;
+	std::string target;
+	char* mapping;
+	size_t mappingLength;
+};
+
+DiskStore::DiskStore(const std::string& path, size_t length, bool scratch)
+	: path(path), mapping(nullptr), mappingLength(length)
+{
+	int fd;
+
+	if (scratch)
+	{
+		/* A unique name, so that other writers beside path keep theirs. */
+		this->path += "XXXXXX";
+		fd = mkstemp(&this->path[0]);
+
+		if (fd >= 0)
+			unlink(this->path.c_str());
+	}
+	else
+	{
+		/* Writing path in place would pull the words out from under anything
+		 * that still has it mapped, and lose its value if we fail part way.
+		 */
+		fd = createReplacement(path, this->path);
+	}
+
+	if (fd < 0)
+		throw std::runtime_error("could not create " + path);
+
+	if (!scratch)
+		target = path;
+
+	if (ftruncate(fd, static_cast<off_t>(length)) != 0)
+	{
+		close(fd);
+		discard();
+		throw std::runtime_error("could not extend " + path);
+	}
+
+	try
+	{
+		map(fd, PROT_READ | PROT_WRITE);
+	}
+	catch (...)
+	{
+		discard();
+		throw;
+	}
+}
+
+DiskStore::DiskStore(const std::string& path)
+	: path(path), mapping(nullptr), mappingLength(0)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw std::runtime_error("could not open " + path);
+
+	struct stat status;
+	if (fstat(fd, &status) != 0)
+	{
+		close(fd);
+		throw std::runtime_error("could not stat " + path);
+	}
+
+	mappingLength = static_cast<size_t>(status.st_size);
+	if (mappingLength == 0)
+	{
+		close(fd);
+		throw std::invalid_argument(path + " is empty");
+	}
+
+	map(fd, PROT_READ);
+}
+
+void DiskStore::map(int fd, int protection)
+{
+	void* result = mmap(nullptr, mappingLength, protection, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (result == MAP_FAILED)
+		throw std::runtime_error("could not map " + path);
+
+	mapping = static_cast<char*>(result);
+}
+
+DiskStore::~DiskStore()
+{
+	if (mapping != nullptr)
+		munmap(mapping, mappingLength);
+
+	discard();
+}
+
+void DiskStore::discard()
+{
+	if (!target.empty())
+		unlink(path.c_str());
+
+	target.clear();
+}
+
+char* DiskStore::data() const
+{
+	return mapping;
+}
+
+size_t DiskStore::length() const
+{
+	return mappingLength;
+}
+
+void DiskStore::replace(size_t length)
+{
+	bool synced = msync(mapping, mappingLength, MS_SYNC) == 0;
+
+	munmap(mapping, mappingLength);
+	mapping = nullptr;
+
+	if (!synced || ::truncate(path.c_str(), static_cast<off_t>(length)) != 0
+		|| std::rename(path.c_str(), target.c_str()) != 0)
+		throw std::runtime_error("could not write " + target);
+
+	target.clear();
+}
+
+BigInt DiskStore::load(const uint32_t* words, size_t count)
+{
+	BigInt value(count == 0 ? BigInt::Words(1, 0) : BigInt::Words(words, words + count));
+
+	value.trim();
+	return value;
+}
+
+const BigInt::Words& DiskStore::words(const BigInt& value)
+{
+	return value.words;
+}
+
+BigInt::Words DiskStore::chunks(const BigInt& value)
+{
+	return value.decimalChunks();
+}
+
+namespace
+{
+	/* Arithmetic modulo 2^64 - 2^32 + 1, which has roots of unity of every
+	 * power of two order up to 2^32. 7 generates its multiplicative group.
+	 */
+	const uint64_t prime = 0xFFFFFFFF00000001ull;
+	const uint64_t epsilon = 0xFFFFFFFFull;
+	const uint64_t generator = 7;
+	const size_t maxTransform = size_t(1) << 32;
+
+	uint64_t addMod(uint64_t a, uint64_t b)
+	{
+		uint64_t sum = a + b;
+
+		if (sum < a)
+			sum += epsilon;
+
+		return sum >= prime ? sum - prime : sum;
+	}
+
+	uint64_t subtractMod(uint64_t a, uint64_t b)
+	{
+		uint64_t difference = a - b;
+
+		return a < b ? difference - epsilon : difference;
+	}
+
+	/* 2^64 is epsilon and 2^96 is -1 modulo the prime. */
+	uint64_t multiplyMod(uint64_t a, uint64_t b)
+	{
+		unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+		uint64_t low = static_cast<uint64_t>(product);
+		uint64_t high = static_cast<uint64_t>(product >> 64);
+		uint64_t highHigh = high >> 32, highLow = high & epsilon;
+
+		uint64_t result = low - highHigh;
+		if (low < highHigh)
+			result -= epsilon;
+
+		uint64_t middle = highLow * epsilon;
+		result += middle;
+		if (result < middle)
+			result += epsilon;
+
+		return result >= prime ? result - prime : result;
+	}
+
+	uint64_t powMod(uint64_t base, uint64_t exponent)
+	{
+		uint64_t result = 1;
+
+		for (; exponent != 0; exponent >>= 1)
+		{
+			if (exponent & 1)
+				result = multiplyMod(result, base);
+
+			base = multiplyMod(base, base);
+		}
+
+		return result;
+	}
+
+	uint64_t rootOfUnity(size_t order, bool inverse)
+	{
+		uint64_t root = powMod(generator, (prime - 1) / order);
+
+		return inverse ? powMod(root, prime - 2) : root;
+	}
+
+	/* Radix-2 transform of n (a power of two) values in memory. */
+	void transform(uint64_t* values, size_t n, bool inverse)
+	{
+		for (size_t i = 1, j = 0; i < n; i++)
+		{
+			size_t bit = n >> 1;
+			for (; j & bit; bit >>= 1)
+				j ^= bit;
+			j ^= bit;
+
+			if (i < j)
+				std::swap(values[i], values[j]);
+		}
+
+		std::vector<uint64_t> twiddles(n / 2);
+
+		for (size_t length = 2; length <= n; length <<= 1)
+		{
+			size_t half = length / 2;
+			uint64_t root = rootOfUnity(length, inverse);
+
+			twiddles[0] = 1;
+			for (size_t j = 1; j < half; j++)
+				twiddles[j] = multiplyMod(twiddles[j - 1], root);
+
+			for (size_t i = 0; i < n; i += length)
+				for (size_t j = 0; j < half; j++)
+				{
+					uint64_t u = values[i + j], v = multiplyMod(values[i + j + half], twiddles[j]);
+
+					values[i + j] = addMod(u, v);
+					values[i + j + half] = subtractMod(u, v);
+				}
+		}
+	}
+
+	void twiddle(uint64_t* values, size_t n, uint64_t step)
+	{
+		uint64_t factor = 1;
+
+		for (size_t i = 0; i < n; i++)
+		{
+			values[i] = multiplyMod(values[i], factor);
+			factor = multiplyMod(factor, step);
+		}
+	}
+
+	void adviseSequential(const void* begin, size_t bytes)
+	{
+		size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		uintptr_t start = reinterpret_cast<uintptr_t>(begin) & ~(page - 1);
+
+		madvise(reinterpret_cast<void*>(start), reinterpret_cast<uintptr_t>(begin) + bytes - start,
+			MADV_SEQUENTIAL);
+	}
+
+	/* The values are a rows x columns matrix stored a row at a time, with
+	 * length = rows * columns. Transforming every column, scaling element
+	 * (r, c) by root^(r c) and then transforming every row gives the length
+	 * point transform, in transposed order; the inverse undoes those steps in
+	 * reverse. As pointwise products don't care about order, the transpose is
+	 * never done.
+	 *
+	 * The rows are transformed in place, one after another. The columns are
+	 * gathered into memory as a slab as wide as the block size allows, so
+	 * that the file is read and written in runs rather than one value per
+	 * row at a time.
+	 */
+	void columnPass(uint64_t* values, size_t rows, size_t columns, uint64_t root, bool inverse)
+	{
+		size_t width = std::min(columns, std::max<size_t>(1, diskBlockBytes / (sizeof(uint64_t) * rows)));
+		std::vector<uint64_t> slab(rows * width);
+
+		for (size_t first = 0; first < columns; first += width)
+		{
+			size_t count = std::min(width, columns - first);
+
+			for (size_t r = 0; r < rows; r++)
+				for (size_t c = 0; c < count; c++)
+					slab[c * rows + r] = values[r * columns + first + c];
+
+			for (size_t c = 0; c < count; c++)
+			{
+				uint64_t* column = &slab[c * rows];
+				uint64_t step = powMod(root, first + c);
+
+				if (inverse)
+					twiddle(column, rows, step);
+
+				transform(column, rows, inverse);
+
+				if (!inverse)
+					twiddle(column, rows, step);
+			}
+
+			for (size_t r = 0; r < rows; r++)
+				for (size_t c = 0; c < count; c++)
+					values[r * columns + first + c] = slab[c * rows + r];
+		}
+	}
+
+	void rowPass(uint64_t* values, size_t rows, size_t columns, bool inverse)
+	{
+		adviseSequential(values, rows * columns * sizeof(uint64_t));
+
+		for (size_t r = 0; r < rows; r++)
+			transform(values + r * columns, columns, inverse);
+	}
+
+	void transformMatrix(uint64_t* values, size_t length, bool inverse)
+	{
+		size_t bits = 0;
+		while ((size_t(1) << bits) < length)
+			bits++;
+
+		size_t rows = size_t(1) << (bits / 2), columns = length / rows;
+		uint64_t root = rootOfUnity(length, inverse);
+
+		if (!inverse)
+		{
+			columnPass(values, rows, columns, root, false);
+			rowPass(values, rows, columns, false);
+		}
+		else
+		{
+			rowPass(values, rows, columns, true);
+			columnPass(values, rows, columns, root, true);
+		}
+	}
+
+	/* Limbs are held in base 2^32 for binary values and base 10^9 for decimal
+	 * ones, and split into digits small enough that a convolution of them
+	 * cannot wrap around the prime.
+	 */
+	struct Radix
+	{
+		uint64_t limbBase;
+		uint64_t digitBase;
+		size_t digitsPerLimb;
+	};
+
+	const Radix binary = { uint64_t(1) << 32, 1 << 16, 2 };
+	const Radix decimal = { 1000000000, 1000, 3 };
+
+	/* Working memory: buffers that are small next to the block size live on
+	 * the heap, and the rest in scratch files.
+	 */
+	class Buffer
+	{
+	public:
+		Buffer(const std::string& path, size_t bytes)
+		{
+			if (bytes > diskBlockBytes / 4)
+			{
+				file.reset(new DiskStore(path, bytes, true));
+				data = file->data();
+			}
+			else
+			{
+				memory.resize((bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+				data = reinterpret_cast<char*>(memory.data());
+			}
+		}
+
+		char* data;
+
+	private:
+		std::unique_ptr<DiskStore> file;
+		std::vector<uint64_t> memory;
+	};
+
+	class Scratch
+	{
+	public:
+		explicit Scratch(const std::string& prefix) : prefix(prefix) {}
+
+		std::shared_ptr<Buffer> create(size_t bytes)
+		{
+			return std::make_shared<Buffer>(prefix + ".scratch", std::max(bytes, sizeof(uint64_t)));
+		}
+
+	private:
+		std::string prefix;
+	};
+
+	/* A magnitude, in a buffer of its own or borrowed from a mapped file. A
+	 * count of zero is the value zero.
+	 */
+	struct Limbs
+	{
+		std::shared_ptr<Buffer> buffer;
+		const uint32_t* words;
+		size_t count;
+
+		uint32_t* writable()
+		{
+			return reinterpret_cast<uint32_t*>(buffer->data);
+		}
+
+		void trim()
+		{
+			while (count > 0 && words[count - 1] == 0)
+				count--;
+		}
+	};
+
+	Limbs allocate(Scratch& scratch, size_t count)
+	{
+		Limbs limbs;
+
+		limbs.buffer = scratch.create(count * sizeof(uint32_t));
+		limbs.words = limbs.writable();
+		limbs.count = count;
+
+		return limbs;
+	}
+
+	Limbs view(const uint32_t* words, size_t count)
+	{
+		Limbs limbs { nullptr, words, count };
+
+		limbs.trim();
+		return limbs;
+	}
+
+	int compare(const Limbs& a, const Limbs& b)
+	{
+		if (a.count != b.count)
+			return a.count < b.count ? -1 : 1;
+
+		for (size_t i = a.count; i > 0; i--)
+			if (a.words[i - 1] != b.words[i - 1])
+				return a.words[i - 1] < b.words[i - 1] ? -1 : 1;
+
+		return 0;
+	}
+
+	/* out = a + b, where out has room for max(a.count, b.count) + 1 limbs. */
+	size_t addInto(uint32_t* out, const Limbs& a, const Limbs& b, const Radix& radix)
+	{
+		size_t count = std::max(a.count, b.count);
+		uint64_t carry = 0;
+
+		adviseSequential(a.words, a.count * sizeof(uint32_t));
+		adviseSequential(b.words, b.count * sizeof(uint32_t));
+
+		for (size_t i = 0; i < count; i++)
+		{
+			uint64_t sum = carry + (i < a.count ? a.words[i] : 0) + (i < b.count ? b.words[i] : 0);
+
+			carry = sum >= radix.limbBase;
+			out[i] = static_cast<uint32_t>(carry ? sum - radix.limbBase : sum);
+		}
+
+		out[count] = static_cast<uint32_t>(carry);
+		return count + 1;
+	}
+
+	/* out = a - b for binary magnitudes with a >= b. */
+	size_t subtractInto(uint32_t* out, const Limbs& a, const Limbs& b)
+	{
+		uint64_t borrow = 0;
+
+		adviseSequential(a.words, a.count * sizeof(uint32_t));
+		adviseSequential(b.words, b.count * sizeof(uint32_t));
+
+		for (size_t i = 0; i < a.count; i++)
+		{
+			uint64_t difference = uint64_t(a.words[i]) - (i < b.count ? b.words[i] : 0) - borrow;
+
+			out[i] = static_cast<uint32_t>(difference);
+			borrow = difference >> 63;
+		}
+
+		return a.count;
+	}
+
+	void loadDigits(uint64_t* digits, const Limbs& limbs, const Radix& radix)
+	{
+		for (size_t i = 0; i < limbs.count; i++)
+		{
+			uint64_t limb = limbs.words[i];
+
+			for (size_t j = 0; j < radix.digitsPerLimb; j++)
+			{
+				*digits++ = limb % radix.digitBase;
+				limb /= radix.digitBase;
+			}
+		}
+	}
+
+	/* out = a * b, where out has room for a.count + b.count limbs. */
+	size_t multiplyInto(uint32_t* out, const Limbs& a, const Limbs& b, const Radix& radix, Scratch& scratch)
+	{
+		if (a.count == 0 || b.count == 0)
+			return 0;
+
+		size_t count = a.count + b.count, digits = count * radix.digitsPerLimb, length = 1;
+		while (length < digits)
+			length <<= 1;
+
+		if (length > maxTransform)
+			throw std::length_error("operands are too large to multiply out of core");
+
+		bool squaring = a.words == b.words && a.count == b.count;
+		std::shared_ptr<Buffer> first(scratch.create(length * sizeof(uint64_t))), second(first);
+		uint64_t* x = reinterpret_cast<uint64_t*>(first->data);
+
+		loadDigits(x, a, radix);
+		transformMatrix(x, length, false);
+
+		if (!squaring)
+		{
+			second = scratch.create(length * sizeof(uint64_t));
+			uint64_t* y = reinterpret_cast<uint64_t*>(second->data);
+
+			loadDigits(y, b, radix);
+			transformMatrix(y, length, false);
+		}
+
+		const uint64_t* y = reinterpret_cast<const uint64_t*>(second->data);
+
+		adviseSequential(x, length * sizeof(uint64_t));
+		adviseSequential(y, length * sizeof(uint64_t));
+
+		for (size_t i = 0; i < length; i++)
+			x[i] = multiplyMod(x[i], y[i]);
+
+		second.reset();
+		transformMatrix(x, length, true);
+
+		/* Undo the transform's scaling and carry the digits back into limbs,
+		 * keeping every intermediate below 2^64.
+		 */
+		uint64_t scale = powMod(length, prime - 2), carry = 0;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			uint64_t limb = 0, place = 1;
+
+			for (size_t j = 0; j < radix.digitsPerLimb; j++)
+			{
+				uint64_t value = multiplyMod(x[i * radix.digitsPerLimb + j], scale);
+				uint64_t low = value % radix.digitBase + carry % radix.digitBase;
+
+				carry = value / radix.digitBase + carry / radix.digitBase + low / radix.digitBase;
+				limb += low % radix.digitBase * place;
+				place *= radix.digitBase;
+			}
+
+			out[i] = static_cast<uint32_t>(limb);
+		}
+
+		return count;
+	}
+
+	Limbs add(const Limbs& a, const Limbs& b, const Radix& radix, Scratch& scratch)
+	{
+		Limbs sum(allocate(scratch, std::max(a.count, b.count) + 1));
+
+		sum.count = addInto(sum.writable(), a, b, radix);
+		sum.trim();
+		return sum;
+	}
+
+	Limbs multiply(const Limbs& a, const Limbs& b, const Radix& radix, Scratch& scratch)
+	{
+		Limbs product(allocate(scratch, a.count + b.count));
+
+		product.count = multiplyInto(product.writable(), a, b, radix, scratch);
+		product.trim();
+		return product;
+	}
+
+	Limbs copy(const SharedWords& words, Scratch& scratch)
+	{
+		Limbs limbs(allocate(scratch, words.size()));
+
+		std::copy(words.begin(), words.end(), limbs.writable());
+		limbs.trim();
+		return limbs;
+	}
+
+	/* Radix conversion splits the value at a power of two times the leaf
+	 * size, so the same powers of the old base (held in the new one) serve
+	 * every level: powers[k] is the old base to the power leaf * 2^k.
+	 */
+	const Limbs& power(std::vector<Limbs>& powers, size_t level, const Radix& radix, Scratch& scratch)
+	{
+		while (powers.size() <= level)
+			powers.push_back(multiply(powers.back(), powers.back(), radix, scratch));
+
+		return powers[level];
+	}
+
+	size_t splitLevel(size_t leaf, size_t count)
+	{
+		size_t level = 0;
+
+		while ((leaf << (level + 1)) < count)
+			level++;
+
+		return level;
+	}
+
+	const size_t leafWords = 256;
+	const size_t leafDigits = 9 * leafWords;
+
+	Limbs toChunks(const uint32_t* words, size_t count, std::vector<Limbs>& powers, Scratch& scratch)
+	{
+		while (count > 0 && words[count - 1] == 0)
+			count--;
+
+		if (count <= leafWords)
+			return copy(DiskStore::chunks(DiskStore::load(words, count)), scratch);
+
+		size_t level = splitLevel(leafWords, count), split = leafWords << level;
+		Limbs low(toChunks(words, split, powers, scratch));
+		Limbs high(toChunks(words + split, count - split, powers, scratch));
+
+		return add(multiply(high, power(powers, level, decimal, scratch), decimal, scratch), low, decimal, scratch);
+	}
+
+	Limbs fromDigits(const char* digits, size_t count, std::vector<Limbs>& powers, Scratch& scratch)
+	{
+		if (count <= leafDigits)
+			return copy(DiskStore::words(BigInt(std::string(digits, count))), scratch);
+
+		size_t level = splitLevel(leafDigits, count), split = leafDigits << level;
+		Limbs high(fromDigits(digits, count - split, powers, scratch));
+		Limbs low(fromDigits(digits + count - split, split, powers, scratch));
+
+		return add(multiply(high, power(powers, level, binary, scratch), binary, scratch), low, binary, scratch);
+	}
+
+	/* Results are written straight after a header in the output file, which
+	 * is cut down to size and moved into place once the final length is
+	 * known.
+	 */
+	MappedBigInt finish(DiskStore& out, size_t count, bool negative, const std::string& path)
+	{
+		uint32_t* words = reinterpret_cast<uint32_t*>(out.data() + sizeof(BigIntFileHeader));
+
+		while (count > 1 && words[count - 1] == 0)
+			count--;
+
+		if (count == 0)
+		{
+			words[0] = 0;
+			count = 1;
+		}
+
+		if (count == 1 && words[0] == 0)
+			negative = false;
+
+		BigIntFileHeader header(negative, count);
+
+		std::memcpy(out.data(), &header, sizeof(header));
+		out.replace(sizeof(header) + count * sizeof(uint32_t));
+
+		return BigInt::mapFile(path);
+	}
+
+	size_t outputLength(size_t count)
+	{
+		return sizeof(BigIntFileHeader) + std::max<size_t>(count, 1) * sizeof(uint32_t);
+	}
+
+	uint32_t* outputWords(DiskStore& out)
+	{
+		return reinterpret_cast<uint32_t*>(out.data() + sizeof(BigIntFileHeader));
+	}
+
+	/* A result replaces the file at path, which must not be an operand's:
+	 * the caller would lose the operand's value under that name.
+	 */
+	void requireDistinct(const MappedBigInt& a, const MappedBigInt& b, const std::string& path)
+	{
+		if (a.isFile(path) || b.isFile(path))
+			throw std::invalid_argument(path + " is one of the operands");
+	}
+
+	bool sameFile(const std::string& first, const std::string& second)
+	{
+		struct stat a, b;
+
+		return stat(first.c_str(), &a) == 0 && stat(second.c_str(), &b) == 0 && a.st_dev == b.st_dev
+			&& a.st_ino == b.st_ino;
+	}
+
+	MappedBigInt addSigned(const MappedBigInt& a, const MappedBigInt& b, bool bNegative, const std::string& path)
+	{
+		requireDistinct(a, b, path);
+
+		Limbs x(view(a.data(), a.length())), y(view(b.data(), b.length()));
+		DiskStore out(path, outputLength(std::max(x.count, y.count) + 1), false);
+
+		if (a.isNegative() == bNegative)
+			return finish(out, addInto(outputWords(out), x, y, binary), bNegative, path);
+
+		if (compare(x, y) >= 0)
+			return finish(out, subtractInto(outputWords(out), x, y), a.isNegative(), path);
+
+		return finish(out, subtractInto(outputWords(out), y, x), bNegative, path);
+	}
+}
+
+MappedBigInt diskAdd(const MappedBigInt& a, const MappedBigInt& b, const std::string& path)
+{
+	return addSigned(a, b, b.isNegative(), path);
+}
+
+MappedBigInt diskSubtract(const MappedBigInt& a, const MappedBigInt& b, const std::string& path)
+{
+	return addSigned(a, b, !b.isNegative(), path);
+}
+
+MappedBigInt diskMultiply(const MappedBigInt& a, const MappedBigInt& b, const std::string& path)
+{
+	requireDistinct(a, b, path);
+
+	Scratch scratch(path);
+	Limbs x(view(a.data(), a.length())), y(view(b.data(), b.length()));
+	DiskStore out(path, outputLength(x.count + y.count), false);
+
+	return finish(out, multiplyInto(outputWords(out), x, y, binary, scratch),
+		a.isNegative() != b.isNegative(), path);
+}
+
+MappedBigInt diskFromDecimal(const std::string& decimalPath, const std::string& path)
+{
+	if (sameFile(decimalPath, path))
+		throw std::invalid_argument(path + " is the decimal file");
+
+	DiskStore text(decimalPath);
+	const char* digits = text.data();
+	size_t count = text.length();
+
+	if (count > 0 && digits[count - 1] == '\n')
+		count--;
+
+	bool negative = count > 0 && digits[0] == '-';
+	if (negative)
+	{
+		digits++;
+		count--;
+	}
+
+	if (count == 0 || !std::all_of(digits, digits + count, [](char c) { return c >= '0' && c <= '9'; }))
+		throw std::invalid_argument(decimalPath + " does not hold a decimal integer");
+
+	Scratch scratch(path);
+	std::vector<Limbs> powers { copy(DiskStore::words(BigInt("1" + std::string(leafDigits, '0'))), scratch) };
+	Limbs value(fromDigits(digits, count, powers, scratch));
+
+	powers.clear();
+
+	DiskStore out(path, outputLength(value.count), false);
+
+	std::copy(value.words, value.words + value.count, outputWords(out));
+	return finish(out, value.count, negative, path);
+}
+
+void diskToDecimal(const MappedBigInt& value, const std::string& decimalPath)
+{
+	if (value.isFile(decimalPath))
+		throw std::invalid_argument(decimalPath + " is the value's own file");
+
+	Scratch scratch(decimalPath);
+	std::vector<Limbs> powers { copy(DiskStore::chunks(BigInt(1) << static_cast<uint32_t>(32 * leafWords)), scratch) };
+	Limbs chunks(toChunks(value.data(), value.length(), powers, scratch));
+
+	powers.clear();
+
+	/* Written beside decimalPath and renamed over it, so a failure part way
+	 * leaves the old file as it was.
+	 */
+	std::string temporary;
+
+	int fd = createReplacement(decimalPath, temporary);
+	if (fd < 0)
+		throw std::runtime_error("could not write " + decimalPath);
+
+	close(fd);
+
+	std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+
+	try
+	{
+		std::string block;
+
+		if (value.isNegative() && chunks.count > 0)
+			block.push_back('-');
+
+		block += std::to_string(chunks.count > 0 ? chunks.words[chunks.count - 1] : 0);
+
+		for (size_t i = chunks.count > 0 ? chunks.count - 1 : 0; i > 0; i--)
+		{
+			char digits[9];
+			uint32_t chunk = chunks.words[i - 1];
+
+			for (size_t j = 9; j > 0; j--)
+			{
+				digits[j - 1] = static_cast<char>('0' + chunk % 10);
+				chunk /= 10;
+			}
+
+			block.append(digits, 9);
+
+			if (block.size() >= 1 << 16)
+			{
+				file.write(block.data(), block.size());
+				block.clear();
+			}
+		}
+
+		file.write(block.data(), block.size());
+	}
+	catch (...)
+	{
+		unlink(temporary.c_str());
+		throw;
+	}
+
+	file.close();
+
+	if (!file || std::rename(temporary.c_str(), decimalPath.c_str()) != 0)
+	{
+		unlink(temporary.c_str());
+		throw std::runtime_error("could not write " + decimalPath);
+	}
+}
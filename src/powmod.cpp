@@ -0,0 +1,540 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "powmod.hpp"
+
+namespace
+{
+	/* Wider Pippenger digits than this cost more in buckets than they save. */
+	const size_t maxDigitBits = 16;
+
+	size_t bitLength(const std::vector<uint32_t>& x)
+	{
+		if (x.empty())
+			return 0;
+
+		size_t bits = 32 * x.size();
+		for (uint32_t top = x.back(); (top & 0x80000000u) == 0; top <<= 1)
+			bits--;
+
+		return bits;
+	}
+
+	bool testBit(const std::vector<uint32_t>& x, const size_t bit)
+	{
+		return bit / 32 < x.size() && ((x[bit / 32] >> (bit % 32)) & 1) != 0;
+	}
+
+	/* The count bits of x from bit up, which may run past its top. */
+	size_t bitsAt(const std::vector<uint32_t>& x, const size_t bit, const size_t count)
+	{
+		size_t value = 0;
+
+		for (size_t i = count; i > 0; i--)
+			value = (value << 1) | (testBit(x, bit + i - 1) ? 1 : 0);
+
+		return value;
+	}
+
+	/* Multiplications, besides squarings, for a sliding window of width
+	 * bits over an exponent of bits bits: its table of odd powers, and on
+	 * average one for every width + 1 bits.
+	 */
+	size_t windowCost(const size_t bits, const size_t width)
+	{
+		return (size_t(1) << (width - 1)) + bits / (width + 1);
+	}
+
+	size_t windowFor(const size_t bits)
+	{
+		size_t width = 1;
+
+		while (width < 8 && windowCost(bits, width + 1) < windowCost(bits, width))
+			width++;
+
+		return width;
+	}
+
+	/* A multiplication into x is a copy while x is still one. */
+	struct Accumulator
+	{
+		std::vector<uint32_t> words;
+		bool one = true;
+	};
+
+	/* Where a sliding window over an exponent ends: after the squaring for
+	 * bit position, multiply by the entry'th odd power of base.
+	 */
+	struct Window
+	{
+		size_t position;
+		size_t base;
+		size_t entry;
+
+		bool operator<(const Window& that) const
+		{
+			return position > that.position;
+		}
+	};
+}
+
+ModularContext::ModularContext(const BigInt& modulus) : value(modulus)
+{
+	if (modulus <= 1u || !modulus.testBit(0))
+		throw std::invalid_argument("the modulus must be odd and greater than one");
+
+	digits = magnitude(modulus);
+
+	/* Newton's iteration doubles the correct low bits of 1 / m each time,
+	 * and m is its own inverse to three bits.
+	 */
+	uint32_t x = digits[0];
+	for (size_t i = 0; i < 4; i++)
+		x *= 2 - digits[0] * x;
+
+	inverse = -x;
+	rSquared = reduced(BigInt(1) << static_cast<uint32_t>(64 * words()));
+	one = reduced(BigInt(1) << static_cast<uint32_t>(32 * words()));
+}
+
+const BigInt& ModularContext::modulus() const
+{
+	return value;
+}
+
+size_t ModularContext::words() const
+{
+	return digits.size();
+}
+
+BigInt ModularContext::mulmod(const BigInt& a, const BigInt& b) const
+{
+	/* a R * b / R = a b, so only one operand needs converting. */
+	Residue product(toMontgomery(a)), other(reduced(b));
+	std::vector<uint32_t> scratch(words() + 2);
+
+	multiply(product.data(), product.data(), other.data(), scratch.data());
+
+	return integer(product);
+}
+
+BigInt ModularContext::powmod(const BigInt& base, const BigInt& exponent) const
+{
+	return multiPowmod(std::vector<BigInt>(1, base), std::vector<BigInt>(1, exponent));
+}
+
+BigInt ModularContext::multiPowmod(const std::vector<BigInt>& bases, const std::vector<BigInt>& exponents) const
+{
+	if (bases.size() != exponents.size())
+		throw std::invalid_argument("there must be an exponent for every base");
+
+	std::vector<Residue> residues;
+	std::vector<std::vector<uint32_t>> powers;
+	size_t bits = 0;
+
+	/* Bases with a zero exponent contribute nothing. */
+	for (size_t i = 0; i < bases.size(); i++)
+	{
+		if (exponents[i].isNegative())
+			throw std::invalid_argument("exponents must not be negative");
+
+		if (exponents[i].isZero())
+			continue;
+
+		residues.push_back(toMontgomery(bases[i]));
+		powers.push_back(magnitude(exponents[i]));
+		bits = std::max(bits, bitLength(powers.back()));
+	}
+
+	if (residues.empty())
+		return BigInt(1);
+
+	/* Each way shares the bits squarings, so compare the multiplications. */
+	size_t strausCost = 0;
+
+	for (const std::vector<uint32_t>& power : powers)
+		strausCost += windowCost(bitLength(power), windowFor(bitLength(power)));
+
+	size_t digitBits = 0, pippengerCost = strausCost;
+
+	for (size_t c = 1; c <= maxDigitBits; c++)
+	{
+		const size_t cost = (bits + c - 1) / c * (residues.size() + (size_t(2) << c));
+
+		if (cost < pippengerCost)
+		{
+			digitBits = c;
+			pippengerCost = cost;
+		}
+	}
+
+	return fromMontgomery(digitBits == 0 ? straus(residues, powers, bits)
+		: pippenger(residues, powers, bits, digitBits));
+}
+
+BigInt multiPowmod(const std::vector<BigInt>& bases, const std::vector<BigInt>& exponents, const BigInt& modulus)
+{
+	return ModularContext(modulus).multiPowmod(bases, exponents);
+}
+
+std::vector<uint32_t> ModularContext::magnitude(const BigInt& x)
+{
+	return std::vector<uint32_t>(x.words.begin(), x.words.end());
+}
+
+ModularContext::Residue ModularContext::reduced(const BigInt& x) const
+{
+	/* BigInt's % takes the sign of the (positive) modulus. */
+	Residue residue(magnitude(x % value));
+	residue.resize(words(), 0);
+
+	return residue;
+}
+
+ModularContext::Residue ModularContext::toMontgomery(const BigInt& x) const
+{
+	Residue residue(reduced(x));
+	std::vector<uint32_t> scratch(words() + 2);
+
+	multiply(residue.data(), residue.data(), rSquared.data(), scratch.data());
+
+	return residue;
+}
+
+BigInt ModularContext::fromMontgomery(const Residue& x) const
+{
+	Residue unit(words(), 0), residue(words());
+	std::vector<uint32_t> scratch(words() + 2);
+
+	unit[0] = 1;
+	multiply(residue.data(), x.data(), unit.data(), scratch.data());
+
+	return integer(residue);
+}
+
+BigInt ModularContext::integer(const Residue& x)
+{
+	BigInt result(BigInt::Words(x.data(), x.data() + x.size()));
+	result.trim();
+
+	return result;
+}
+
+void ModularContext::multiply(uint32_t* r, const uint32_t* a, const uint32_t* b, uint32_t* scratch) const
+{
+	/* Coarsely integrated operand scanning: add a[i] b, then a multiple of m
+	 * that clears the low word, and shift that word out, so the sum stays
+	 * below 2m in n + 2 words throughout.
+	 */
+	const size_t n = words();
+	const uint32_t* m = digits.data();
+	uint32_t* t = scratch;
+
+	std::fill(t, t + n + 2, 0);
+
+	for (size_t i = 0; i < n; i++)
+	{
+		uint64_t carry = 0;
+
+		for (size_t j = 0; j < n; j++)
+		{
+			const uint64_t sum = static_cast<uint64_t>(a[i]) * b[j] + t[j] + carry;
+			t[j] = static_cast<uint32_t>(sum);
+			carry = sum >> 32;
+		}
+
+		uint64_t sum = static_cast<uint64_t>(t[n]) + carry;
+		t[n] = static_cast<uint32_t>(sum);
+		t[n + 1] = static_cast<uint32_t>(sum >> 32);
+
+		const uint32_t q = t[0] * inverse;
+
+		carry = (static_cast<uint64_t>(q) * m[0] + t[0]) >> 32;
+
+		for (size_t j = 1; j < n; j++)
+		{
+			sum = static_cast<uint64_t>(q) * m[j] + t[j] + carry;
+			t[j - 1] = static_cast<uint32_t>(sum);
+			carry = sum >> 32;
+		}
+
+		sum = static_cast<uint64_t>(t[n]) + carry;
+		t[n - 1] = static_cast<uint32_t>(sum);
+		t[n] = t[n + 1] + static_cast<uint32_t>(sum >> 32);
+	}
+
+	bool subtract = t[n] != 0;
+
+	for (size_t j = n; !subtract && j > 0; j--)
+	{
+		if (t[j - 1] != m[j - 1])
+		{
+			subtract = t[j - 1] > m[j - 1];
+			break;
+		}
+
+		/* Equal to m. */
+		if (j == 1)
+			subtract = true;
+	}
+
+	if (subtract)
+	{
+		uint64_t borrow = 0;
+
+		for (size_t j = 0; j < n; j++)
+		{
+			const uint64_t difference = static_cast<uint64_t>(t[j]) - m[j] - borrow;
+			r[j] = static_cast<uint32_t>(difference);
+			borrow = difference >> 63;
+		}
+	}
+	else
+		std::copy(t, t + n, r);
+}
+
+ModularContext::Residue ModularContext::straus(const std::vector<Residue>& bases,
+	const std::vector<std::vector<uint32_t>>& exponents, const size_t bits) const
+{
+	const size_t n = words();
+	std::vector<uint32_t> scratch(n + 2);
+
+	/* The odd powers base, base^3, ... base^(2^width - 1) of each base, and
+	 * the windows to multiply them in at, scanning from the top bit.
+	 */
+	std::vector<std::vector<uint32_t>> tables(bases.size());
+	std::vector<Window> windows;
+
+	for (size_t i = 0; i < bases.size(); i++)
+	{
+		const std::vector<uint32_t>& exponent = exponents[i];
+		const size_t width = windowFor(bitLength(exponent));
+		std::vector<uint32_t>& table = tables[i];
+
+		table.resize(n << (width - 1));
+		std::copy(bases[i].begin(), bases[i].end(), table.begin());
+
+		if (width > 1)
+		{
+			Residue square(n);
+			multiply(square.data(), bases[i].data(), bases[i].data(), scratch.data());
+
+			for (size_t entry = 1; entry < (size_t(1) << (width - 1)); entry++)
+				multiply(&table[n * entry], &table[n * (entry - 1)], square.data(), scratch.data());
+		}
+
+		for (size_t bit = bitLength(exponent); bit > 0;)
+		{
+			if (!testBit(exponent, bit - 1))
+			{
+				bit--;
+				continue;
+			}
+
+			/* The longest window from here that ends in a set bit. */
+			size_t low = bit > width ? bit - width : 0;
+			while (!testBit(exponent, low))
+				low++;
+
+			const Window window = { low, i, bitsAt(exponent, low, bit - low) / 2 };
+			windows.push_back(window);
+			bit = low;
+		}
+	}
+
+	std::stable_sort(windows.begin(), windows.end());
+
+	Accumulator result;
+	result.words.resize(n);
+
+	std::vector<Window>::const_iterator next = windows.begin();
+
+	for (size_t bit = bits; bit > 0; bit--)
+	{
+		if (!result.one)
+			multiply(result.words.data(), result.words.data(), result.words.data(), scratch.data());
+
+		for (; next != windows.end() && next->position == bit - 1; ++next)
+		{
+			const uint32_t* power = &tables[next->base][n * next->entry];
+
+			if (result.one)
+				std::copy(power, power + n, result.words.begin());
+			else
+				multiply(result.words.data(), result.words.data(), power, scratch.data());
+
+			result.one = false;
+		}
+	}
+
+	return result.words;
+}
+
+ModularContext::Residue ModularContext::pippenger(const std::vector<Residue>& bases,
+	const std::vector<std::vector<uint32_t>>& exponents, const size_t bits, const size_t digitBits) const
+{
+	const size_t n = words(), bucketCount = (size_t(1) << digitBits) - 1;
+	std::vector<uint32_t> scratch(n + 2);
+
+	Accumulator result;
+	result.words.resize(n);
+
+	std::vector<Accumulator> buckets(bucketCount);
+	for (Accumulator& bucket : buckets)
+		bucket.words.resize(n);
+
+	for (size_t digit = (bits + digitBits - 1) / digitBits; digit > 0; digit--)
+	{
+		if (!result.one)
+			for (size_t i = 0; i < digitBits; i++)
+				multiply(result.words.data(), result.words.data(), result.words.data(), scratch.data());
+
+		for (Accumulator& bucket : buckets)
+			bucket.one = true;
+
+		for (size_t i = 0; i < bases.size(); i++)
+		{
+			const size_t value = bitsAt(exponents[i], (digit - 1) * digitBits, digitBits);
+
+			if (value == 0)
+				continue;
+
+			Accumulator& bucket = buckets[value - 1];
+
+			if (bucket.one)
+				bucket.words = bases[i];
+			else
+				multiply(bucket.words.data(), bucket.words.data(), bases[i].data(), scratch.data());
+
+			bucket.one = false;
+		}
+
+		/* The product of bucket[v]^v is that of the running products of the
+		 * buckets from the top down.
+		 */
+		Accumulator running, total;
+		running.words.resize(n);
+		total.words.resize(n);
+
+		for (size_t value = bucketCount; value > 0; value--)
+		{
+			const Accumulator& bucket = buckets[value - 1];
+
+			if (!bucket.one)
+			{
+				if (running.one)
+					running.words = bucket.words;
+				else
+					multiply(running.words.data(), running.words.data(), bucket.words.data(), scratch.data());
+
+				running.one = false;
+			}
+
+			if (running.one)
+				continue;
+
+			if (total.one)
+				total.words = running.words;
+			else
+				multiply(total.words.data(), total.words.data(), running.words.data(), scratch.data());
+
+			total.one = false;
+		}
+
+		if (total.one)
+			continue;
+
+		if (result.one)
+			result.words = total.words;
+		else
+			multiply(result.words.data(), result.words.data(), total.words.data(), scratch.data());
+
+		result.one = false;
+	}
+
+	return result.one ? one : result.words;
+}
+
+FixedBasePowmod::FixedBasePowmod(const ModularContext& context, const BigInt& base, const size_t exponentBits)
+	: modular(&context), base(base), bits(std::max<size_t>(exponentBits, 1)), teeth(1)
+{
+	/* Past eight teeth the table outgrows what it saves. */
+	while (teeth < 8 && (size_t(2) << teeth) <= bits)
+		teeth++;
+
+	spacing = (bits + teeth - 1) / teeth;
+
+	const size_t n = context.words();
+	std::vector<uint32_t> scratch(n + 2);
+
+	/* Entry 2^k is base^(2^(k spacing)), and every other entry the product
+	 * of its highest bit's entry and that of the rest.
+	 */
+	table.resize(n << teeth);
+	std::copy(context.one.begin(), context.one.end(), table.begin());
+
+	ModularContext::Residue power(context.toMontgomery(base));
+
+	for (size_t k = 0; k < teeth; k++)
+	{
+		if (k > 0)
+			for (size_t i = 0; i < spacing; i++)
+				context.multiply(power.data(), power.data(), power.data(), scratch.data());
+
+		const size_t top = size_t(1) << k;
+		std::copy(power.begin(), power.end(), &table[n * top]);
+
+		for (size_t rest = 1; rest < top; rest++)
+			context.multiply(&table[n * (top + rest)], &table[n * top], &table[n * rest], scratch.data());
+	}
+}
+
+const ModularContext& FixedBasePowmod::context() const
+{
+	return *modular;
+}
+
+size_t FixedBasePowmod::exponentBits() const
+{
+	return bits;
+}
+
+BigInt FixedBasePowmod::pow(const BigInt& exponent) const
+{
+	if (exponent.isNegative())
+		throw std::invalid_argument("exponents must not be negative");
+
+	if (exponent.size() > bits)
+		return modular->powmod(base, exponent);
+
+	const size_t n = modular->words();
+	const std::vector<uint32_t> digits(ModularContext::magnitude(exponent));
+	std::vector<uint32_t> scratch(n + 2);
+
+	Accumulator result;
+	result.words = modular->one;
+
+	for (size_t column = spacing; column > 0; column--)
+	{
+		if (!result.one)
+			modular->multiply(result.words.data(), result.words.data(), result.words.data(), scratch.data());
+
+		size_t entry = 0;
+		for (size_t k = 0; k < teeth; k++)
+			entry |= (testBit(digits, k * spacing + column - 1) ? size_t(1) : 0) << k;
+
+		if (entry == 0)
+			continue;
+
+		const uint32_t* power = &table[n * entry];
+
+		if (result.one)
+			std::copy(power, power + n, result.words.begin());
+		else
+			modular->multiply(result.words.data(), result.words.data(), power, scratch.data());
+
+		result.one = false;
+	}
+
+	return modular->fromMontgomery(result.words);
+}
@@ -0,0 +1,332 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "rational.hpp"
+
+BigRational::Normalization BigRational::normalization = BigRational::Normalization::Lazy;
+size_t BigRational::growthFactor = 4;
+
+BigRational::BigRational() : top(0), bottom(1), reduced(true), reference(1)
+{
+}
+
+BigRational::BigRational(const BigInt& integer) : top(integer), bottom(1), reduced(true), reference(bits())
+{
+}
+
+BigRational::BigRational(const BigInt& numerator, const BigInt& denominator)
+{
+	if (denominator.isZero())
+		throw std::invalid_argument("division by zero");
+
+	BigInt a(numerator), b(denominator);
+
+	if (b.isNegative())
+	{
+		a.negate();
+		b.negate();
+	}
+
+	const bool lowest = b == 1u;
+	const size_t size = a.size() + b.size();
+
+	assign(std::move(a), std::move(b), lowest, size);
+}
+
+BigRational::BigRational(const std::string& str)
+{
+	const size_t slash = str.find('/');
+
+	if (str.empty() || slash == 0 || slash + 1 == str.length())
+		throw std::invalid_argument("invalid number string");
+
+	if (slash == std::string::npos)
+		*this = BigRational(BigInt(str));
+	else
+		*this = BigRational(BigInt(str.substr(0, slash)), BigInt(str.substr(slash + 1)));
+}
+
+BigRational& BigRational::operator=(const BigRational& that)
+{
+	/* BigInt only assigns from a non-const reference. */
+	top = BigInt(that.top);
+	bottom = BigInt(that.bottom);
+	reduced = that.reduced;
+	reference = that.reference;
+
+	return *this;
+}
+
+BigRational::operator std::string() const
+{
+	BigRational lowest(*this);
+	lowest.normalize();
+
+	std::string text(lowest.top);
+
+	if (lowest.bottom != 1u)
+		text += "/" + static_cast<std::string>(lowest.bottom);
+
+	return text;
+}
+
+std::ostream& operator<<(std::ostream& out, const BigRational& value)
+{
+	return out << static_cast<std::string>(value);
+}
+
+BigInt BigRational::numerator() const
+{
+	BigRational lowest(*this);
+	lowest.normalize();
+
+	return std::move(lowest.top);
+}
+
+BigInt BigRational::denominator() const
+{
+	BigRational lowest(*this);
+	lowest.normalize();
+
+	return std::move(lowest.bottom);
+}
+
+void BigRational::normalize()
+{
+	if (reduced)
+		return;
+
+	BigInt divisor(gcd(top, bottom));
+
+	if (divisor != 1u)
+	{
+		top = top.divexact(divisor);
+		bottom = bottom.divexact(divisor);
+	}
+
+	reduced = true;
+	reference = bits();
+}
+
+bool BigRational::isNormalized() const
+{
+	return reduced;
+}
+
+BigInt BigRational::floor() const
+{
+	return top / bottom;
+}
+
+bool BigRational::isZero() const
+{
+	return top.isZero();
+}
+
+bool BigRational::isNegative() const
+{
+	return top.isNegative();
+}
+
+bool BigRational::operator==(const BigRational& that) const
+{
+	/* Lowest terms are unique, so those compare as they are. */
+	if (reduced && that.reduced)
+		return top == that.top && bottom == that.bottom;
+
+	return compare(that) == 0;
+}
+
+bool BigRational::operator!=(const BigRational& that) const
+{
+	return !(*this == that);
+}
+
+bool BigRational::operator<(const BigRational& that) const
+{
+	return compare(that) < 0;
+}
+
+bool BigRational::operator>(const BigRational& that) const
+{
+	return compare(that) > 0;
+}
+
+bool BigRational::operator<=(const BigRational& that) const
+{
+	return compare(that) <= 0;
+}
+
+bool BigRational::operator>=(const BigRational& that) const
+{
+	return compare(that) >= 0;
+}
+
+BigRational BigRational::operator-() const
+{
+	BigRational copy(*this);
+	copy.top.negate();
+	return copy;
+}
+
+BigRational BigRational::operator+(const BigRational& that) const
+{
+	BigRational copy(*this);
+	copy += that;
+	return copy;
+}
+
+BigRational BigRational::operator-(const BigRational& that) const
+{
+	BigRational copy(*this);
+	copy -= that;
+	return copy;
+}
+
+BigRational BigRational::operator*(const BigRational& that) const
+{
+	BigRational copy(*this);
+	copy *= that;
+	return copy;
+}
+
+BigRational BigRational::operator/(const BigRational& that) const
+{
+	BigRational copy(*this);
+	copy /= that;
+	return copy;
+}
+
+BigRational& BigRational::operator+=(const BigRational& that)
+{
+	const size_t previous = std::max(reference, that.reference);
+
+	/* Adding an integer c to a/b changes nothing that b has in common with
+	 * the numerator, since gcd(a + c b, b) = gcd(a, b).
+	 */
+	if (that.bottom == 1u)
+		assign(top + that.top * bottom, BigInt(bottom), reduced, previous);
+
+	else if (bottom == 1u)
+		assign(top * that.bottom + that.top, BigInt(that.bottom), that.reduced, previous);
+
+	else if (normalization == Normalization::Eager && reduced && that.reduced)
+	{
+		/* With g = gcd(b, d), a/b + c/d = (a d/g + c b/g) / (b d/g), and the
+		 * only factors that numerator can share with the denominator are
+		 * those of g (Knuth, 4.5.1).
+		 */
+		BigInt common(gcd(bottom, that.bottom));
+
+		if (common == 1u)
+			assign(top * that.bottom + that.top * bottom, bottom * that.bottom, true, previous);
+		else
+		{
+			BigInt left(bottom.divexact(common));
+			BigInt sum(top * that.bottom.divexact(common) + that.top * left);
+			BigInt cancel(gcd(sum, common));
+
+			if (cancel == 1u)
+				assign(std::move(sum), left * that.bottom, true, previous);
+			else
+				assign(sum.divexact(cancel), left * that.bottom.divexact(cancel), true, previous);
+		}
+	}
+
+	else if (bottom == that.bottom)
+		assign(top + that.top, BigInt(bottom), false, previous);
+
+	else
+		assign(top * that.bottom + that.top * bottom, bottom * that.bottom, false, previous);
+
+	return *this;
+}
+
+BigRational& BigRational::operator-=(const BigRational& that)
+{
+	return *this += -that;
+}
+
+BigRational& BigRational::operator*=(const BigRational& that)
+{
+	const size_t previous = std::max(reference, that.reference);
+
+	if (normalization == Normalization::Eager && reduced && that.reduced)
+	{
+		/* For a/b * c/d in lowest terms, any common factor of the product is
+		 * one of a's with d or c's with b, and those gcds are of values half
+		 * the size of the product's.
+		 */
+		BigInt a(top), b(bottom), c(that.top), d(that.bottom);
+		BigInt first(gcd(a, d)), second(gcd(c, b));
+
+		if (first != 1u)
+		{
+			a = a.divexact(first);
+			d = d.divexact(first);
+		}
+
+		if (second != 1u)
+		{
+			c = c.divexact(second);
+			b = b.divexact(second);
+		}
+
+		assign(a * c, b * d, true, previous);
+	}
+	else
+	{
+		const bool integers = bottom == 1u && that.bottom == 1u;
+		assign(top * that.top, bottom * that.bottom, integers, previous);
+	}
+
+	return *this;
+}
+
+BigRational& BigRational::operator/=(const BigRational& that)
+{
+	if (that.isZero())
+		throw std::invalid_argument("division by zero");
+
+	BigRational reciprocal(that);
+	std::swap(reciprocal.top, reciprocal.bottom);
+
+	if (reciprocal.bottom.isNegative())
+	{
+		reciprocal.top.negate();
+		reciprocal.bottom.negate();
+	}
+
+	return *this *= reciprocal;
+}
+
+size_t BigRational::bits() const
+{
+	return top.size() + bottom.size();
+}
+
+void BigRational::assign(BigInt&& numerator, BigInt&& denominator, const bool lowest, const size_t previous)
+{
+	top = std::move(numerator);
+	bottom = std::move(denominator);
+	reduced = lowest;
+	reference = lowest ? bits() : previous;
+
+	/* Below a couple of words a gcd costs little more than the arithmetic. */
+	if (!reduced && (normalization == Normalization::Eager
+		|| bits() > growthFactor * std::max<size_t>(reference, 64)))
+		normalize();
+}
+
+int BigRational::compare(const BigRational& that) const
+{
+	if (isNegative() != that.isNegative())
+		return isNegative() ? -1 : 1;
+
+	/* The denominators are positive, so cross-multiplying keeps the order. */
+	BigInt left(bottom == that.bottom ? top : top * that.bottom);
+	BigInt right(bottom == that.bottom ? that.top : that.top * bottom);
+
+	return left < right ? -1 : left > right ? 1 : 0;
+}
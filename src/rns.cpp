@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "crt.hpp"
+#include "rns.hpp"
+
+namespace
+{
+	/* Every prime in a basis is in (2^30, 2^31), so residues of one channel
+	 * are less than twice the modulus of any other, and the Montgomery sum
+	 * t + m p below stays within 64 bits.
+	 */
+	const uint32_t largestPrime = 0x7FFFFFFF;
+
+	uint32_t powmod(uint64_t base, uint32_t exponent, uint32_t p)
+	{
+		uint64_t result = 1;
+
+		for (base %= p; exponent != 0; exponent >>= 1)
+		{
+			if (exponent & 1)
+				result = result * base % p;
+
+			base = base * base % p;
+		}
+
+		return static_cast<uint32_t>(result);
+	}
+
+	/* Miller-Rabin with bases 2, 7 and 61 is exact below 2^32. */
+	bool isPrime(const uint32_t n)
+	{
+		if (n < 2 || n % 2 == 0)
+			return n == 2;
+
+		uint32_t odd = n - 1, twos = 0;
+		while (odd % 2 == 0)
+		{
+			odd /= 2;
+			twos++;
+		}
+
+		for (uint32_t base : { 2u, 7u, 61u })
+		{
+			if (base % n == 0)
+				continue;
+
+			uint64_t x = powmod(base, odd, n);
+			if (x == 1 || x == n - 1)
+				continue;
+
+			uint32_t i = 1;
+			for (; i < twos && x != n - 1; i++)
+				x = x * x % n;
+
+			if (x != n - 1)
+				return false;
+		}
+
+		return true;
+	}
+
+	/* t / 2^32 mod p, for t < p 2^32. */
+	inline uint32_t redc(const uint64_t t, const uint32_t p, const uint32_t inverse)
+	{
+		uint32_t m = static_cast<uint32_t>(t) * inverse;
+		uint32_t u = static_cast<uint32_t>((t + static_cast<uint64_t>(m) * p) >> 32);
+
+		return u >= p ? u - p : u;
+	}
+
+	/* The channel loops are independent across channels, so on x86_64 they
+	 * are built for AVX2 as well and the loader picks the version for the
+	 * CPU.
+	 */
+#if defined(__x86_64__) && defined(__GNUC__)
+#define CHANNEL_KERNEL __attribute__((target_clones("avx2", "default")))
+#else
+#define CHANNEL_KERNEL
+#endif
+
+	CHANNEL_KERNEL
+	void addChannels(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* p, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			uint32_t sum = a[i] + b[i];
+			r[i] = sum >= p[i] ? sum - p[i] : sum;
+		}
+	}
+
+	CHANNEL_KERNEL
+	void subtractChannels(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* p, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			uint32_t difference = a[i] + p[i] - b[i];
+			r[i] = difference >= p[i] ? difference - p[i] : difference;
+		}
+	}
+
+	CHANNEL_KERNEL
+	void multiplyChannels(uint32_t* r, const uint32_t* a, const uint32_t* b, const uint32_t* p,
+		const uint32_t* inverses, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+			r[i] = redc(static_cast<uint64_t>(a[i]) * b[i], p[i], inverses[i]);
+	}
+
+	/* One step of Garner's algorithm over the later channels: sum += digit
+	 * weight and weight *= prime, modulo each channel's p, where sum is
+	 * plain and weight is in Montgomery form.
+	 */
+	CHANNEL_KERNEL
+	void garnerChannels(uint32_t* sum, uint32_t* weight, const uint32_t digit, const uint32_t prime,
+		const uint32_t* p, const uint32_t* inverses, const uint32_t* rSquared, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			uint32_t d = digit >= p[i] ? digit - p[i] : digit;
+			uint32_t q = prime >= p[i] ? prime - p[i] : prime;
+			uint32_t s = sum[i] + redc(static_cast<uint64_t>(d) * weight[i], p[i], inverses[i]);
+
+			sum[i] = s >= p[i] ? s - p[i] : s;
+			q = redc(static_cast<uint64_t>(q) * rSquared[i], p[i], inverses[i]);
+			weight[i] = redc(static_cast<uint64_t>(weight[i]) * q, p[i], inverses[i]);
+		}
+	}
+
+	/* weight *= prime modulo each channel's p, with weight in Montgomery
+	 * form: the weight half of garnerChannels.
+	 */
+	CHANNEL_KERNEL
+	void scaleChannels(uint32_t* weight, const uint32_t prime, const uint32_t* p, const uint32_t* inverses,
+		const uint32_t* rSquared, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			uint32_t q = prime >= p[i] ? prime - p[i] : prime;
+
+			q = redc(static_cast<uint64_t>(q) * rSquared[i], p[i], inverses[i]);
+			weight[i] = redc(static_cast<uint64_t>(weight[i]) * q, p[i], inverses[i]);
+		}
+	}
+}
+
+RNSBasis::RNSBasis(const size_t bits) : capacity(bits), modulus(1)
+{
+	for (uint32_t candidate = largestPrime; modulus.size() <= bits + 1; candidate -= 2)
+		if (isPrime(candidate))
+		{
+			primes.push_back(candidate);
+			modulus *= candidate;
+		}
+
+	for (size_t begin = 0; begin < primes.size(); begin += groupSize)
+	{
+		BigInt group(1);
+
+		for (size_t i = begin; i < primes.size() && i < begin + groupSize; i++)
+			group *= primes[i];
+
+		groups.push_back(group);
+	}
+
+	const size_t count = primes.size();
+
+	/* The product of the earlier primes in every channel, in Montgomery form,
+	 * starting from one (R mod p).
+	 */
+	std::vector<uint32_t> earlier(count);
+
+	for (size_t j = 0; j < count; j++)
+	{
+		const uint32_t p = primes[j];
+
+		/* Newton's iteration doubles the correct low bits of 1 / p. */
+		uint32_t x = p;
+		for (size_t i = 0; i < 4; i++)
+			x *= 2 - p * x;
+
+		const uint64_t r = (uint64_t(1) << 32) % p;
+
+		inverses.push_back(-x);
+		rSquared.push_back(static_cast<uint32_t>(r * r % p));
+		earlier[j] = static_cast<uint32_t>(r);
+	}
+
+	/* Each prime is multiplied into all the later channels at once, so the
+	 * quadratic part of the work is the same vectorised loop as Garner's.
+	 */
+	for (size_t j = 0; j < count; j++)
+	{
+		const uint32_t p = primes[j];
+		const uint64_t r = (uint64_t(1) << 32) % p;
+		const uint32_t product = redc(earlier[j], p, inverses[j]);
+
+		garnerInverses.push_back(static_cast<uint32_t>(powmod(product, p - 2, p) * r % p));
+
+		scaleChannels(earlier.data() + j + 1, p, primes.data() + j + 1, inverses.data() + j + 1,
+			rSquared.data() + j + 1, count - j - 1);
+	}
+}
+
+size_t RNSBasis::size() const
+{
+	return primes.size();
+}
+
+size_t RNSBasis::bits() const
+{
+	return capacity;
+}
+
+const std::vector<uint32_t>& RNSBasis::moduli() const
+{
+	return primes;
+}
+
+const BigInt& RNSBasis::product() const
+{
+	return modulus;
+}
+
+RNSInt::RNSInt(const RNSBasis& basis) : system(&basis), residues(basis.size(), 0)
+{
+}
+
+RNSInt::RNSInt(const BigInt& value, const RNSBasis& basis) : system(&basis)
+{
+	if (value.size() > basis.capacity)
+		throw std::invalid_argument("value is too wide for the residue number system");
+
+	/* BigInt % is floored, so even a negative value reduces to its residues. */
+	std::vector<BigInt> remainders(remaindersOf(value, basis.groups));
+
+	residues.reserve(basis.size());
+
+	for (size_t group = 0; group < remainders.size(); group++)
+	{
+		const size_t begin = group * RNSBasis::groupSize;
+		const size_t end = std::min(begin + RNSBasis::groupSize, basis.size());
+		const std::vector<uint32_t> primes(basis.primes.begin() + begin, basis.primes.begin() + end);
+		const std::vector<uint32_t> channels(::residues(remainders[group], primes));
+
+		residues.insert(residues.end(), channels.begin(), channels.end());
+	}
+
+	multiplyChannels(residues.data(), residues.data(), basis.rSquared.data(), basis.primes.data(),
+		basis.inverses.data(), residues.size());
+}
+
+RNSInt::operator BigInt() const
+{
+	const RNSBasis& basis = *system;
+	const size_t count = basis.size();
+
+	/* Garner's algorithm finds the mixed radix digits of the value, where
+	 * digit j is worth the product of the primes before it, one channel at a
+	 * time; each digit is then folded into every later channel at once.
+	 */
+	std::vector<uint32_t> digits(count), sum(count, 0), weight(count);
+
+	for (size_t i = 0; i < count; i++)
+		weight[i] = redc(basis.rSquared[i], basis.primes[i], basis.inverses[i]);
+
+	for (size_t j = 0; j < count; j++)
+	{
+		const uint32_t p = basis.primes[j];
+		uint32_t difference = residue(j) + p - sum[j];
+
+		if (difference >= p)
+			difference -= p;
+
+		digits[j] = redc(static_cast<uint64_t>(difference) * basis.garnerInverses[j], p, basis.inverses[j]);
+
+		garnerChannels(sum.data() + j + 1, weight.data() + j + 1, digits[j], p, basis.primes.data() + j + 1,
+			basis.inverses.data() + j + 1, basis.rSquared.data() + j + 1, count - j - 1);
+	}
+
+	BigInt value(digits[count - 1]);
+
+	for (size_t j = count - 1; j > 0; j--)
+	{
+		value *= basis.primes[j - 1];
+		value += digits[j - 1];
+	}
+
+	/* The residues cover [0, M); the upper half stands for the negatives. */
+	if (value > basis.modulus >> 1)
+		value -= basis.modulus;
+
+	return value;
+}
+
+const RNSBasis& RNSInt::basis() const
+{
+	return *system;
+}
+
+uint32_t RNSInt::residue(const size_t channel) const
+{
+	return redc(residues[channel], system->primes[channel], system->inverses[channel]);
+}
+
+RNSInt RNSInt::operator-() const
+{
+	RNSInt negated(*system);
+	negated -= *this;
+	return negated;
+}
+
+RNSInt RNSInt::operator+(const RNSInt& that) const
+{
+	RNSInt copy(*this);
+	copy += that;
+	return copy;
+}
+
+RNSInt RNSInt::operator-(const RNSInt& that) const
+{
+	RNSInt copy(*this);
+	copy -= that;
+	return copy;
+}
+
+RNSInt RNSInt::operator*(const RNSInt& that) const
+{
+	RNSInt copy(*this);
+	copy *= that;
+	return copy;
+}
+
+RNSInt& RNSInt::operator+=(const RNSInt& that)
+{
+	requireBasis(that);
+	addChannels(residues.data(), residues.data(), that.residues.data(), system->primes.data(), residues.size());
+
+	return *this;
+}
+
+RNSInt& RNSInt::operator-=(const RNSInt& that)
+{
+	requireBasis(that);
+	subtractChannels(residues.data(), residues.data(), that.residues.data(), system->primes.data(),
+		residues.size());
+
+	return *this;
+}
+
+RNSInt& RNSInt::operator*=(const RNSInt& that)
+{
+	requireBasis(that);
+	multiplyChannels(residues.data(), residues.data(), that.residues.data(), system->primes.data(),
+		system->inverses.data(), residues.size());
+
+	return *this;
+}
+
+void RNSInt::requireBasis(const RNSInt& that) const
+{
+	if (system != that.system)
+		throw std::invalid_argument("values are in different residue number systems");
+}
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "outofcore.hpp"
+#include "series.hpp"
+#include "tree.hpp"
+
+namespace
+{
+	/* One of P, Q or T: in memory, or once it is large enough, mapped from a
+	 * spill file.
+	 */
+	struct Operand
+	{
+		BigInt value;
+		std::unique_ptr<MappedBigInt> file;
+
+		size_t words() const
+		{
+			return file ? file->length() : (value.size() + 31) / 32;
+		}
+	};
+
+	struct Node
+	{
+		Operand P;
+		Operand Q;
+		Operand T;
+	};
+
+	struct Context
+	{
+		const Series& series;
+		const SplitOptions& options;
+		std::atomic<uint64_t> files;
+
+		Context(const Series& series, const SplitOptions& options) : series(series), options(options), files(0)
+		{
+		}
+
+		bool spilling(const Operand& x, const Operand& y, const size_t words) const
+		{
+			return !options.spillDirectory.empty() && (x.file || y.file || words >= options.spillWords);
+		}
+
+		std::string scratchPath()
+		{
+			return options.spillDirectory + "/split-" + std::to_string(files++) + ".tmp";
+		}
+
+		/* The mapping outlives the file's name, so nothing is left behind on
+		 * disk however the computation ends.
+		 */
+		void adopt(Operand& operand, MappedBigInt&& mapped, const std::string& path)
+		{
+			operand.file.reset(new MappedBigInt(std::move(mapped)));
+			operand.value = BigInt();
+			std::remove(path.c_str());
+		}
+
+		const MappedBigInt& onDisk(Operand& operand)
+		{
+			if (!operand.file)
+			{
+				const std::string path(scratchPath());
+
+				operand.value.save(path);
+				adopt(operand, BigInt::mapFile(path), path);
+			}
+
+			return *operand.file;
+		}
+	};
+
+	BigInt inMemory(const Operand& operand)
+	{
+		return operand.file ? BigInt(*operand.file) : operand.value;
+	}
+
+	Operand multiply(Operand& x, Operand& y, Context& context)
+	{
+		Operand product;
+
+		if (context.spilling(x, y, x.words() + y.words()))
+		{
+			const std::string path(context.scratchPath());
+			context.adopt(product, diskMultiply(context.onDisk(x), context.onDisk(y), path), path);
+		}
+		else
+			product.value = inMemory(x) * inMemory(y);
+
+		return product;
+	}
+
+	Operand add(Operand& x, Operand& y, Context& context)
+	{
+		Operand sum;
+
+		if (context.spilling(x, y, std::max(x.words(), y.words())))
+		{
+			const std::string path(context.scratchPath());
+			context.adopt(sum, diskAdd(context.onDisk(x), context.onDisk(y), path), path);
+		}
+		else
+			sum.value = inMemory(x) + inMemory(y);
+
+		return sum;
+	}
+
+	Node split(Context& context, const uint64_t begin, const uint64_t end, const bool wantP, unsigned threads)
+	{
+		Node node;
+
+		if (end - begin == 1)
+		{
+			BigInt p(context.series.p(begin));
+
+			node.Q.value = context.series.q(begin);
+			node.T.value = context.series.a(begin) * p;
+
+			if (wantP)
+				node.P.value = std::move(p);
+
+			return node;
+		}
+
+		/* The left half's P goes into T, so it is always wanted; the right
+		 * half's only if this node's is.
+		 */
+		const uint64_t mid = begin + (end - begin) / 2;
+		Node left, right;
+
+		if (threads > 1 && end - begin >= parallelCutoff)
+		{
+			std::future<Node> pending = std::async(std::launch::async, split, std::ref(context), begin, mid,
+				true, threads / 2);
+			right = split(context, mid, end, wantP, threads - threads / 2);
+			left = pending.get();
+		}
+		else
+		{
+			left = split(context, begin, mid, true, 1);
+			right = split(context, mid, end, wantP, 1);
+		}
+
+		Operand first(multiply(left.T, right.Q, context)), second(multiply(left.P, right.T, context));
+
+		node.T = add(first, second, context);
+		node.Q = multiply(left.Q, right.Q, context);
+
+		if (wantP)
+			node.P = multiply(left.P, right.P, context);
+
+		return node;
+	}
+}
+
+SeriesSplit splitSeries(const Series& series, const uint64_t begin, const uint64_t end,
+	const SplitOptions& options, const bool wantP)
+{
+	if (begin >= end)
+		throw std::invalid_argument("the range of terms is empty");
+
+	Context context(series, options);
+	Node node(split(context, begin, end, wantP, options.threads != 0 ? options.threads : defaultThreads()));
+
+	SeriesSplit result;
+	result.P = inMemory(node.P);
+	result.Q = inMemory(node.Q);
+	result.T = inMemory(node.T);
+
+	return result;
+}
+
+BigFloat sumSeries(const Series& series, const uint64_t terms, const size_t precision,
+	const SplitOptions& options)
+{
+	SeriesSplit sum(splitSeries(series, 0, terms, options));
+
+	return BigFloat(sum.T, precision) / BigFloat(sum.Q, precision);
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <new>
+
+#include "counters.hpp"
+#include "sharedwords.hpp"
+
+SharedWords::SharedWords() : block(nullptr), count(0)
+{
+}
+
+SharedWords::SharedWords(const size_t count, const uint32_t value)
+	: block(allocate(count)), count(count)
+{
+	std::fill(block->words(), block->words() + count, value);
+}
+
+SharedWords::SharedWords(const uint32_t* first, const uint32_t* last)
+	: block(allocate(last - first)), count(last - first)
+{
+	std::copy(first, last, block->words());
+}
+
+SharedWords::SharedWords(const SharedWords& that) : block(that.block), count(that.count)
+{
+	if (block != nullptr)
+		block->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+SharedWords::SharedWords(SharedWords&& that) : block(that.block), count(that.count)
+{
+	that.block = nullptr;
+	that.count = 0;
+}
+
+SharedWords SharedWords::borrow(const uint32_t* words, const size_t count, void* owner, const size_t ownerLength,
+	void (*dispose)(void*, size_t))
+{
+	SharedWords borrowed;
+
+	borrowed.block = new Block(0);
+	borrowed.block->start = const_cast<uint32_t*>(words);
+	borrowed.block->owner = owner;
+	borrowed.block->ownerLength = ownerLength;
+	borrowed.block->dispose = dispose;
+	borrowed.count = count;
+
+	return borrowed;
+}
+
+SharedWords::~SharedWords()
+{
+	release(block);
+}
+
+SharedWords& SharedWords::operator=(const SharedWords& that)
+{
+	/* Take the new reference first, in case that shares our block. */
+	if (that.block != nullptr)
+		that.block->references.fetch_add(1, std::memory_order_relaxed);
+
+	release(block);
+
+	block = that.block;
+	count = that.count;
+
+	return *this;
+}
+
+SharedWords& SharedWords::operator=(SharedWords&& that)
+{
+	if (this != &that)
+	{
+		release(block);
+
+		block = that.block;
+		count = that.count;
+
+		that.block = nullptr;
+		that.count = 0;
+	}
+
+	return *this;
+}
+
+bool SharedWords::shared() const
+{
+	return block != nullptr && block->references.load(std::memory_order_acquire) != 1;
+}
+
+void SharedWords::reserve(const size_t capacity)
+{
+	/* A shared block is copied now, at the size that is about to be needed. */
+	if (capacity > this->capacity() || shared())
+		reallocate(std::max(capacity, count));
+}
+
+void SharedWords::shrink_to_fit()
+{
+	if (count < capacity())
+		reallocate(count);
+}
+
+void SharedWords::resize(const size_t size, const uint32_t value)
+{
+	if (size > count)
+	{
+		/* Callers resize to the length they need, so that is all the room
+		 * made; push_back() is what grows geometrically.
+		 */
+		if (size > capacity())
+			reallocate(size);
+		else
+			grow(size);
+
+		std::fill(block->words() + count, block->words() + size, value);
+	}
+
+	count = size;
+}
+
+void SharedWords::assign(const size_t size, const uint32_t value)
+{
+	/* The old words aren't needed, so there is nothing to copy. */
+	if (size > capacity() || shared())
+	{
+		Block* fresh = allocate(size);
+
+		release(block);
+		block = fresh;
+	}
+
+	std::fill(block->words(), block->words() + size, value);
+	count = size;
+}
+
+SharedWords::Block* SharedWords::allocate(const size_t capacity)
+{
+	void* memory = ::operator new(sizeof(Block) + capacity * sizeof(uint32_t));
+	BIGINT_SCOPE_ALLOCATION();
+
+	return new (memory) Block(capacity);
+}
+
+void SharedWords::release(Block* block)
+{
+	/* The release half orders this copy's reads before the delete; the
+	 * acquire half orders the delete after every other copy's.
+	 */
+	if (block != nullptr && block->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		if (block->dispose != nullptr)
+		{
+			block->dispose(block->owner, block->ownerLength);
+			delete block;
+			return;
+		}
+
+		block->~Block();
+		::operator delete(block);
+	}
+}
+
+void SharedWords::grow(const size_t size)
+{
+	/* A shared block is copied at its full capacity rather than by unshare(),
+	 * which keeps only count words, since up to size are about to be written.
+	 */
+	if (size > capacity())
+		reallocate(std::max(size, 2 * count));
+	else if (shared())
+		reallocate(capacity());
+}
+
+void SharedWords::reallocate(const size_t capacity)
+{
+	Block* fresh = allocate(capacity);
+
+	if (count != 0)
+		std::copy(block->words(), block->words() + count, fresh->words());
+
+	release(block);
+	block = fresh;
+}
@@ -40,11 +40,10 @@ BigInt& BigInt::operator<<=(const uint32_t that)
 	}
 
 	if (bitShifts != 0)
-	{
 		*this >>= bitShifts;
 
-		trim();
-	}
+	/* Shifting zero by whole words would otherwise leave zero words behind. */
+	trim();
 
 	return *this;
 }
@@ -72,10 +71,10 @@ BigInt& BigInt::operator>>=(const uint32_t that)
 
 	if (bitShifts != 0)
 	{
-		const uint32_t mask = (1 << bitShifts) - 1;
+		const uint32_t mask = (1u << bitShifts) - 1;
 		uint32_t lastHigh = 0, nextHigh = 0;
 
-		for (auto word = words.rbegin(); word != words.rend(); ++word)
+		for (auto word = words.rbegin(), last = words.rend(); word != last; ++word)
 		{
 			nextHigh = *word & mask;
 			*word >>= bitShifts;
@@ -0,0 +1,266 @@
+#include <cctype>
+#include <string>
+
+#include "bigint.hpp"
+
+namespace
+{
+	/* Collects characters in a fixed buffer and hands them to the stream
+	 * buffer a block at a time, so output never needs the whole number as
+	 * text.
+	 */
+	class BlockWriter
+	{
+	public:
+		BlockWriter(std::ostream& out) : out(out), used(0), failed(false)
+		{
+		}
+
+		~BlockWriter()
+		{
+			flush();
+		}
+
+		void put(char c)
+		{
+			if (used == sizeof(buffer))
+				flush();
+
+			buffer[used++] = c;
+		}
+
+		void put(char c, size_t count)
+		{
+			for (size_t i = 0; i < count; i++)
+				put(c);
+		}
+
+		void flush()
+		{
+			if (used != 0 && out.rdbuf()->sputn(buffer, used) != static_cast<std::streamsize>(used))
+				failed = true;
+
+			used = 0;
+		}
+
+		bool ok() const
+		{
+			return !failed;
+		}
+
+	private:
+		std::ostream& out;
+		char buffer[4096];
+		size_t used;
+		bool failed;
+	};
+
+	int digitValue(char c, int radix)
+	{
+		int digit = -1;
+
+		if (c >= '0' && c <= '9')
+			digit = c - '0';
+		else if (c >= 'a' && c <= 'f')
+			digit = c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')
+			digit = c - 'A' + 10;
+
+		return digit < radix ? digit : -1;
+	}
+}
+
+std::ostream& operator<<(std::ostream& out, const BigInt& value)
+{
+	std::ostream::sentry sentry(out);
+
+	if (!sentry)
+		return out;
+
+	std::ios_base::fmtflags flags = out.flags();
+	std::ios_base::fmtflags base = flags & std::ios_base::basefield;
+
+	/* Hexadecimal and octal digits come straight from the words, a few bits
+	 * at a time from the top. Decimal needs base 10^9 chunks first, which
+	 * take a word each rather than a byte per digit.
+	 */
+	size_t bitsPerDigit = base == std::ios_base::hex ? 4 : base == std::ios_base::oct ? 3 : 0;
+	size_t bits = value.size();
+	BigInt::Words chunks;
+	size_t digits;
+
+	if (bitsPerDigit != 0)
+		digits = bits == 0 ? 1 : (bits + bitsPerDigit - 1) / bitsPerDigit;
+	else
+	{
+		chunks = value.decimalChunks();
+		digits = BigInt::chunkDigits * (chunks.size() - 1) + std::to_string(chunks.back()).size();
+	}
+
+	std::string prefix;
+
+	if (value.isNegative())
+		prefix = "-";
+	else if (flags & std::ios_base::showpos)
+		prefix = "+";
+
+	if ((flags & std::ios_base::showbase) && !value.isZero())
+	{
+		if (base == std::ios_base::hex)
+			prefix += (flags & std::ios_base::uppercase) ? "0X" : "0x";
+		else if (base == std::ios_base::oct)
+			prefix += "0";
+	}
+
+	size_t length = prefix.size() + digits;
+	size_t width = out.width() > 0 ? static_cast<size_t>(out.width()) : 0;
+	size_t padding = width > length ? width - length : 0;
+	std::ios_base::fmtflags adjust = flags & std::ios_base::adjustfield;
+
+	BlockWriter writer(out);
+
+	if (adjust != std::ios_base::left && adjust != std::ios_base::internal)
+		writer.put(out.fill(), padding);
+
+	for (auto c : prefix)
+		writer.put(c);
+
+	if (adjust == std::ios_base::internal)
+		writer.put(out.fill(), padding);
+
+	if (bitsPerDigit != 0)
+	{
+		const char* alphabet = (flags & std::ios_base::uppercase) ? "0123456789ABCDEF" : "0123456789abcdef";
+
+		for (size_t i = digits; i > 0; i--)
+		{
+			size_t bit = (i - 1) * bitsPerDigit;
+			uint32_t digit = 0;
+
+			for (size_t j = bitsPerDigit; j > 0; j--)
+			{
+				size_t position = bit + j - 1;
+				uint32_t set = position < bits ? (value.words[position / 32] >> (position % 32)) & 1 : 0;
+
+				digit = (digit << 1) | set;
+			}
+
+			writer.put(alphabet[digit]);
+		}
+	}
+	else
+	{
+		for (auto c : std::to_string(chunks.back()))
+			writer.put(c);
+
+		for (size_t i = chunks.size() - 1; i > 0; i--)
+		{
+			uint32_t chunk = chunks[i - 1];
+			uint32_t scale = BigInt::chunkBase / 10;
+
+			for (size_t j = 0; j < BigInt::chunkDigits; j++)
+			{
+				writer.put(static_cast<char>('0' + chunk / scale % 10));
+				scale /= 10;
+			}
+		}
+	}
+
+	if (adjust == std::ios_base::left)
+		writer.put(out.fill(), padding);
+
+	writer.flush();
+
+	if (!writer.ok())
+		out.setstate(std::ios_base::badbit);
+
+	out.width(0);
+
+	return out;
+}
+
+std::istream& operator>>(std::istream& in, BigInt& value)
+{
+	std::istream::sentry sentry(in);
+
+	if (!sentry)
+		return in;
+
+	std::ios_base::fmtflags base = in.flags() & std::ios_base::basefield;
+	bool hex = base == std::ios_base::hex;
+	int radix = hex ? 16 : base == std::ios_base::oct ? 8 : 10;
+	bool negative = false;
+	std::string digits;
+	std::streambuf* buffer = in.rdbuf();
+	int c = buffer->sgetc();
+
+	if (c == '-' || c == '+')
+	{
+		negative = c == '-';
+		c = buffer->snextc();
+	}
+
+	if (hex && c == '0')
+	{
+		digits.push_back('0');
+		c = buffer->snextc();
+
+		if (c == 'x' || c == 'X')
+		{
+			digits.clear();
+			c = buffer->snextc();
+		}
+	}
+
+	while (c != std::char_traits<char>::eof() && digitValue(static_cast<char>(c), radix) >= 0)
+	{
+		digits.push_back(static_cast<char>(c));
+		c = buffer->snextc();
+	}
+
+	if (c == std::char_traits<char>::eof())
+		in.setstate(std::ios_base::eofbit);
+
+	if (digits.empty())
+	{
+		in.setstate(std::ios_base::failbit);
+		return in;
+	}
+
+	BigInt result;
+
+	if (radix != 10)
+	{
+		/* Hex and octal digits are four and three bits, so the words fill
+		 * from the end; an octal digit may straddle two of them. A leading
+		 * "0", as showbase writes octal, is just another zero digit.
+		 */
+		size_t bitsPerDigit = hex ? 4 : 3;
+		result.words.assign((digits.size() * bitsPerDigit + 31) / 32, 0);
+
+		for (size_t i = 0; i < digits.size(); i++)
+		{
+			size_t bit = bitsPerDigit * (digits.size() - i - 1);
+			uint64_t digit = static_cast<uint64_t>(digitValue(digits[i], radix)) << (bit % 32);
+
+			result.words[bit / 32] |= static_cast<uint32_t>(digit);
+
+			if ((digit >> 32) != 0)
+				result.words[bit / 32 + 1] |= static_cast<uint32_t>(digit >> 32);
+		}
+
+		result.trim();
+	}
+	else
+	{
+		std::map<size_t, BigInt> powers;
+		result = BigInt::parseDigits(digits, 0, digits.size(), powers);
+	}
+
+	if (negative)
+		result.negate();
+
+	value = std::move(result);
+
+	return in;
+}
@@ -9,19 +9,21 @@ BigInt BigInt::operator-() const
 
 void BigInt::negate()
 {
-	positive = !positive;
+	/* Zero is always positive. */
+	if (!isZero())
+		positive = !positive;
 }
 
 BigInt BigInt::operator--()
 {
 	BigInt old(*this);
-	*this -= one;
+	addScalar(true, 1);
 	return old;
 }
 
 BigInt& BigInt::operator--(const int)
 {
-	*this -= one;
+	addScalar(true, 1);
 	return *this;
 }
 
@@ -95,30 +97,36 @@ BigInt& BigInt::operator-=(const BigInt::Words& that)
 { 
 	const uint64_t borrow = 0x100000000ull;
 
+	/* Taking the pointers once makes the words this copy's own up front;
+	 * that may be words itself, so it is read after.
+	 */
+	uint32_t* difference = words.data();
+	const uint32_t* subtrahend = that.data();
+
 	for (size_t i = 0; i < words.size(); i++)
 	{	
 		if (i < that.size())
 		{
-			if (words[i] >= that[i])
-				words[i] -= that[i];
+			if (difference[i] >= subtrahend[i])
+				difference[i] -= subtrahend[i];
 			else
 			{
-				uint64_t sum = borrow + static_cast<uint64_t>(words[i]) - static_cast<uint64_t>(that[i]);
+				uint64_t sum = borrow + static_cast<uint64_t>(difference[i]) - static_cast<uint64_t>(subtrahend[i]);
 				size_t j = i + 1;
 
-				words[i] = static_cast<uint32_t>(sum);
+				difference[i] = static_cast<uint32_t>(sum);
 
 				/* We perform the borrow; if any words to the left are 0, they
 				 * become the maximum value and we continue borrowing from the
 				 * left.
 				 */
-				while (words[j] == 0)
+				while (difference[j] == 0)
 				{
-					words[j++] = 0xFFFFFFFF;
+					difference[j++] = 0xFFFFFFFF;
 				}
 				
 				/* The last word we borrow from is decreased. */
-				--words[j];
+				--difference[j];
 			}
 		}
 	}
@@ -126,4 +134,52 @@ BigInt& BigInt::operator-=(const BigInt::Words& that)
 	trim();
 
 	return *this;
-}
\ No newline at end of file
+}
+
+BigInt BigInt::operator-(const int that) const
+{
+	BigInt copy(*this);
+	copy -= that;
+	return copy;
+}
+
+BigInt BigInt::operator-(const uint32_t that) const
+{
+	BigInt copy(*this);
+	copy -= that;
+	return copy;
+}
+
+BigInt BigInt::operator-(const int64_t that) const
+{
+	BigInt copy(*this);
+	copy -= that;
+	return copy;
+}
+
+BigInt BigInt::operator-(const uint64_t that) const
+{
+	BigInt copy(*this);
+	copy -= that;
+	return copy;
+}
+
+BigInt& BigInt::operator-=(const int that)
+{
+	return *this -= static_cast<int64_t>(that);
+}
+
+BigInt& BigInt::operator-=(const uint32_t that)
+{
+	return addScalar(true, that);
+}
+
+BigInt& BigInt::operator-=(const int64_t that)
+{
+	return addScalar(that >= 0, magnitudeOf(that));
+}
+
+BigInt& BigInt::operator-=(const uint64_t that)
+{
+	return addScalar(true, that);
+}
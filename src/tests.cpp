@@ -1,9 +1,31 @@
 #include <string>
 #include <iostream>
+#include <sstream>
 #include <vector>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <functional>
+#include <iomanip>
 #include <stdexcept>
+#include <thread>
+#include <sys/stat.h>
+#include "accumulator.hpp"
+#include "batch.hpp"
+#include "bigfloat.hpp"
 #include "bigint.hpp"
+#include "counters.hpp"
+#include "crt.hpp"
+#include "ct.hpp"
+#include "fixedint.hpp"
+#include "literal.hpp"
+#include "mapped.hpp"
+#include "outofcore.hpp"
+#include "powmod.hpp"
+#include "rational.hpp"
+#include "rns.hpp"
+#include "series.hpp"
+#include "sharedwords.hpp"
 
 using namespace std;
 
@@ -137,7 +159,9 @@ bool test_addition()
 		{"340282366920938463463374607431768211456", "-10", "340282366920938463463374607431768211446"},
 		{"123490182349012384190234812903412341", "-340823048234902342902345123452435", "123149359300777481847332467779959906"},
 		{"-340823048234902342902345123452435", "123490182349012384190234812903412341", "123149359300777481847332467779959906"},
-		{"-340823048234902342902345123452435", "-340823048234902342902345123452", "-341163871283137245245247468575887"}
+		{"-340823048234902342902345123452435", "-340823048234902342902345123452", "-341163871283137245245247468575887"},
+		{"0", "-1", "-1"},
+		{"-4294967296", "4294967296", "0"}
 	};
 
 	cout << "test_addition:" << endl;
@@ -296,7 +320,9 @@ bool test_division()
 		{"23419283471289374", "1289347128934", "18163"},
 		{"23419283471289374", "-1289347128934", "-18164"},
 		{"-1890234189234", "-1293478", "1461357"},
-		{"-110535373948910675079005112", "8956589984726", "-12341234123412"}
+		{"-110535373948910675079005112", "8956589984726", "-12341234123412"},
+		{"3", "7", "0"},
+		{"-3", "7", "-1"}
 	};
 
 	cout << "test_division:" << endl;
@@ -336,7 +362,10 @@ bool test_mod()
 		{"5", "3", "2"},
 		{"5", "-3", "-1"},
 		{"-5", "-3", "-2"},
-		{"2341293784", "-123", "-23"}
+		{"2341293784", "-123", "-23"},
+		{"3", "5", "3"},
+		{"-5", "3", "1"},
+		{"-6", "3", "0"}
 	};
 
 	cout << "test_mod:" << endl;
@@ -375,6 +404,8 @@ bool test_mul()
 		{"-1238941238497", "12398471238947", "-15360977312250430202142659"},
 		{"1238941238497", "-12398471238947", "-15360977312250430202142659"},
 		{"-1238941238497", "-12398471238947", "15360977312250430202142659"},
+		{"1238941238497", "-1", "-1238941238497"},
+		{"-12398471238947", "0", "0"},
 		{"12019197179026560467995728591684751358286626816120191971790265604679957285916847513582866268161201919717902656046799572859168475135828662681612019197179026560467995728591684751358286626816",
 		 "12019197179026560467995728591684751358286626816120191971790265604679957285916847513582866268161201919717902656046799572859168475135828662681612019197179026560467995728591684751358286626816",
 		 "144461100828320029045015067204914164888462360657483578692554809334852674223170870485419545069135225463768264183792551977742925993219544665316956151406109802742365772132541432815848938799422711259728803235887159943532437773697255062243666722920445316268427574199813160448607201407811063332436026001779835489643019431602418521931854594356675988408753952372879072587187650297856"}
@@ -400,6 +431,2044 @@ bool test_mul()
 	return success;
 }
 
+bool test_product_tree()
+{
+	bool success = true;
+
+	vector<size_t> counts { 0, 1, 2, 3, 7, 100, 257 };
+
+	cout << "test_product_tree:" << endl;
+	for (auto count : counts)
+	{
+		vector<BigInt> values;
+		BigInt expected(1);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			BigInt value(BigInt("4294967311") * static_cast<uint32_t>(i * 2654435761u + 1));
+
+			if (i % 3 == 0)
+				value.negate();
+
+			values.push_back(value);
+			expected *= value;
+		}
+
+		BigInt product(productOf(values));
+
+		if (product == expected)
+			cout << "productOf(" << count << " values) == " << (string)expected << endl;
+		else
+		{
+			cout << "productOf(" << count << " values) != " << (string)expected
+			     << " (got " << (string)product << " instead)" << endl;
+
+			success = false;
+		}
+	}
+
+	return success;
+}
+
+bool test_remainder_tree()
+{
+	bool success = true;
+
+	vector<string> values {
+		"0",
+		"12",
+		"-1561749840894125169814814058904901914569840569840894089415146908974098",
+		"100000000000000000000000000000000000000000000000000000000000000000000"
+	};
+
+	vector<BigInt> moduli;
+	for (uint32_t i = 0; i < 150; i++)
+		moduli.push_back(BigInt(i * 7919u + 3) * (i + 1));
+
+	cout << "test_remainder_tree:" << endl;
+	for (auto value : values)
+	{
+		BigInt x(value);
+		vector<BigInt> remainders(remaindersOf(x, moduli));
+
+		for (size_t i = 0; i < moduli.size(); i++)
+		{
+			if (remainders[i] != x % moduli[i])
+			{
+				cout << value << " % " << (string)moduli[i] << " != " << (string)(x % moduli[i])
+				     << " (got " << (string)remainders[i] << " instead)" << endl;
+
+				success = false;
+			}
+		}
+
+		cout << "remaindersOf(" << value << ", " << moduli.size() << " moduli) checked" << endl;
+	}
+
+	return success;
+}
+
+bool test_factorial()
+{
+	bool success = true;
+
+	BigInt expected(1);
+
+	cout << "test_factorial:" << endl;
+	for (uint32_t n = 0; n <= 120; n++)
+	{
+		if (n > 0)
+			expected *= n;
+
+		BigInt result(factorial(n));
+
+		if (result != expected)
+		{
+			cout << n << "! != " << (string)expected << " (got " << (string)result << " instead)" << endl;
+			success = false;
+		}
+	}
+
+	if (success)
+		cout << "0! through 120! checked" << endl;
+
+	return success;
+}
+
+bool test_binomial()
+{
+	bool success = true;
+
+	struct Test
+	{
+		uint32_t n, k;
+		string result;
+	};
+
+	vector<Test> tests
+	{
+		{0, 0, "1"},
+		{5, 7, "0"},
+		{10, 3, "120"},
+		{52, 5, "2598960"},
+		{100, 50, "100891344545564193334812497256"},
+		{200, 1, "200"}
+	};
+
+	cout << "test_binomial:" << endl;
+	for (auto test : tests)
+	{
+		BigInt result(binomial(test.n, test.k));
+
+		cout << "binomial(" << test.n << ", " << test.k << ")";
+		if (result == BigInt(test.result))
+			cout << " == " << test.result << endl;
+		else
+		{
+			cout << " != " << test.result << " (got " << (string)result << " instead)" << endl;
+			success = false;
+		}
+	}
+
+	return success;
+}
+
+bool test_primorial()
+{
+	bool success = true;
+
+	struct Test
+	{
+		uint32_t n;
+		string result;
+	};
+
+	vector<Test> tests
+	{
+		{0, "1"},
+		{2, "2"},
+		{10, "210"},
+		{30, "6469693230"},
+		{100, "2305567963945518424753102147331756070"}
+	};
+
+	cout << "test_primorial:" << endl;
+	for (auto test : tests)
+	{
+		BigInt result(primorial(test.n));
+
+		cout << test.n << "#";
+		if (result == BigInt(test.result))
+			cout << " == " << test.result << endl;
+		else
+		{
+			cout << " != " << test.result << " (got " << (string)result << " instead)" << endl;
+			success = false;
+		}
+	}
+
+	return success;
+}
+
+BigInt fromWords(const vector<uint32_t>& words)
+{
+	BigInt result;
+
+	for (auto word = words.crbegin(); word != words.crend(); ++word)
+		result = (result << 32) + BigInt(*word);
+
+	return result;
+}
+
+bool test_constant_time()
+{
+	bool success = true;
+	const size_t n = 4;
+
+	uint32_t state = 12345;
+	auto next = [&state]() { state = state * 1664525u + 1013904223u; return state; };
+
+	cout << "test_constant_time:" << endl;
+	for (size_t round = 0; round < 20; round++)
+	{
+		vector<uint32_t> a(n), b(n), m(n), e(2), r(n);
+
+		for (size_t i = 0; i < n; i++)
+		{
+			a[i] = next();
+			b[i] = round % 5 == 0 ? a[i] : next();
+			m[i] = next() >> (i == n - 1 ? round % 32 : 0);
+		}
+		m[0] |= 1;
+		e[0] = next();
+		e[1] = next() >> 16;
+
+		BigInt bigA(fromWords(a)), bigB(fromWords(b)), bigM(fromWords(m)), bigE(fromWords(e));
+		BigInt base = BigInt(1) << static_cast<uint32_t>(32 * n);
+
+		uint32_t carry = ct_add(r.data(), a.data(), b.data(), n);
+		if (fromWords(r) + BigInt(carry) * base != bigA + bigB)
+		{
+			cout << "ct_add failed in round " << round << endl;
+			success = false;
+		}
+
+		uint32_t borrow = ct_sub(r.data(), a.data(), b.data(), n);
+		if (fromWords(r) - BigInt(borrow) * base != bigA - bigB)
+		{
+			cout << "ct_sub failed in round " << round << endl;
+			success = false;
+		}
+
+		if (ct_equal(a.data(), b.data(), n) != (bigA == bigB) || ct_less(a.data(), b.data(), n) != (bigA < bigB))
+		{
+			cout << "ct_equal/ct_less failed in round " << round << endl;
+			success = false;
+		}
+
+		ct_select(r.data(), a.data(), b.data(), n, round % 2);
+		if (fromWords(r) != (round % 2 ? bigA : bigB))
+		{
+			cout << "ct_select failed in round " << round << endl;
+			success = false;
+		}
+
+		ct_mulmod(r.data(), a.data(), b.data(), m.data(), n);
+		if (fromWords(r) != bigA * bigB % bigM)
+		{
+			cout << "ct_mulmod failed in round " << round << endl;
+			success = false;
+		}
+
+		BigInt expected(1), power(bigA % bigM);
+		for (size_t bit = 0; bit < 64; bit++)
+		{
+			if ((e[bit / 32] >> (bit % 32)) & 1)
+				expected = expected * power % bigM;
+			power = power * power % bigM;
+		}
+
+		ct_powmod(r.data(), a.data(), e.data(), e.size(), m.data(), n);
+		if (fromWords(r) != expected)
+		{
+			cout << "ct_powmod failed in round " << round << endl;
+			success = false;
+		}
+	}
+
+	if (success)
+		cout << "20 rounds of 128-bit operations checked" << endl;
+
+	return success;
+}
+
+bool test_fixed_int()
+{
+	bool success = true;
+
+	typedef FixedInt<256> Int256;
+
+	vector<string> values {
+		"0", "1", "-1", "4294967295", "-4294967296",
+		"1289371928311231231", "-1289371928311231231",
+		"79228162514264337593543950335", "-79228162514264337593543950335",
+		"340823048234902342902345123452435", "-123149359300777481847332467779959906"
+	};
+
+	cout << "test_fixed_int:" << endl;
+	for (auto left : values)
+	{
+		BigInt bigLeft(left);
+		Int256 fixedLeft(left);
+
+		if ((string)fixedLeft != left || (BigInt)fixedLeft != bigLeft || fixedLeft.size() != bigLeft.size())
+		{
+			cout << left << " does not round trip (got " << (string)fixedLeft << " instead)" << endl;
+			success = false;
+		}
+
+		if ((BigInt)(fixedLeft << 67) != (bigLeft << 67) || (BigInt)(fixedLeft >> 37) != (bigLeft >> 37)
+		    || (BigInt)(fixedLeft * 3141592653u) != bigLeft * 3141592653u
+		    || fixedLeft % 1000000007u != bigLeft % 1000000007u)
+		{
+			cout << left << " shifts or scalar operations differ from BigInt" << endl;
+			success = false;
+		}
+
+		for (auto right : values)
+		{
+			BigInt bigRight(right);
+			Int256 fixedRight(right);
+
+			if ((BigInt)(fixedLeft + fixedRight) != bigLeft + bigRight
+			    || (BigInt)(fixedLeft - fixedRight) != bigLeft - bigRight
+			    || (BigInt)(fixedLeft * fixedRight) != bigLeft * bigRight
+			    || (fixedLeft < fixedRight) != (bigLeft < bigRight)
+			    || (fixedLeft == fixedRight) != (bigLeft == bigRight))
+			{
+				cout << left << " and " << right << " differ from BigInt" << endl;
+				success = false;
+			}
+
+			if (!bigRight.isZero()
+			    && ((BigInt)(fixedLeft / fixedRight) != bigLeft / bigRight
+			        || (BigInt)(fixedLeft % fixedRight) != bigLeft % bigRight))
+			{
+				cout << left << " / " << right << " differs from BigInt (got "
+				     << (string)(fixedLeft / fixedRight) << " rem " << (string)(fixedLeft % fixedRight) << ")" << endl;
+				success = false;
+			}
+		}
+	}
+
+	Int256 wrapped(BigInt(1) << 256);
+	if (!wrapped.isZero() || !(Int256(BigInt(1) << 255)).isNegative())
+	{
+		cout << "FixedInt<256> does not wrap at 2^256" << endl;
+		success = false;
+	}
+
+	if (success)
+		cout << values.size() << " values checked against BigInt" << endl;
+
+	return success;
+}
+
+bool test_literal()
+{
+	bool success = true;
+
+	struct Test
+	{
+		BigInt literal;
+		string value;
+	};
+
+	vector<Test> tests
+	{
+		{0_big, "0"},
+		{4294967295_big, "4294967295"},
+		{4294967296_big, "4294967296"},
+		{-18446744073709551616_big, "-18446744073709551616"},
+		{123456789012345678901234567890_big, "123456789012345678901234567890"},
+		{1561749840894125169814814058904901914569840569840894089415146908974098_big,
+		 "1561749840894125169814814058904901914569840569840894089415146908974098"}
+	};
+
+	cout << "test_literal:" << endl;
+	for (auto test : tests)
+	{
+		if (test.literal == BigInt(test.value))
+			cout << test.value << "_big == " << test.value << endl;
+		else
+		{
+			cout << test.value << "_big != " << test.value << " (got " << (string)test.literal << " instead)" << endl;
+			success = false;
+		}
+	}
+
+	return success;
+}
+
+bool test_thresholds()
+{
+	bool success = true;
+
+	size_t karatsuba = BigInt::karatsubaThreshold, parse = BigInt::parseThreshold;
+
+	uint32_t state = 777;
+	auto next = [&state]() { state = state * 1664525u + 1013904223u; return state; };
+
+	cout << "test_thresholds:" << endl;
+	for (size_t length : { 2, 3, 17, 64, 65, 200 })
+	{
+		vector<uint32_t> a(length), b(length / 2 + 1 + length % 7);
+		for (auto& word : a)
+			word = next();
+		for (auto& word : b)
+			word = next();
+
+		BigInt left(fromWords(a)), right(fromWords(b));
+		right.negate();
+
+		BigInt::karatsubaThreshold = 1000000;
+		BigInt::parseThreshold = 1000000;
+		BigInt expected(left * right), square(left * left);
+		string decimal(expected);
+
+		BigInt::karatsubaThreshold = 2;
+		BigInt::parseThreshold = 10;
+
+		if (left * right != expected || left * left != square || BigInt(decimal) != expected)
+		{
+			cout << "Karatsuba or split parsing differs at " << length << " words" << endl;
+			success = false;
+		}
+		else
+			cout << length << " x " << b.size() << " words agree across thresholds" << endl;
+	}
+
+	BigInt::karatsubaThreshold = karatsuba;
+	BigInt::parseThreshold = parse;
+
+	return success;
+}
+
+bool test_counters()
+{
+	bool success = true;
+
+	resetCounters();
+
+	BigInt product(BigInt("123456789012345678901234567890") * BigInt("987654321098765432109876543210"));
+	string decimal(product);
+
+	vector<CounterValues> counters(snapshotCounters());
+
+	cout << "test_counters:" << endl;
+	if (counters.size() != static_cast<size_t>(Counter::Count))
+	{
+		cout << "snapshot has " << counters.size() << " counters" << endl;
+		success = false;
+	}
+
+	for (auto& counter : counters)
+	{
+#ifdef BIGINT_INSTRUMENT
+		bool wrong = (counter.name == "multiply" || counter.name == "parse" || counter.name == "to_string")
+			&& (counter.calls == 0 || counter.allocations == 0);
+#else
+		bool wrong = counter.calls != 0;
+#endif
+
+		if (wrong)
+		{
+			cout << counter.name << " counted " << counter.calls << " calls" << endl;
+			success = false;
+		}
+	}
+
+#ifdef BIGINT_INSTRUMENT
+	/* The multiplications inside a parse count, but their time is the parse's. */
+	{
+		size_t parse = BigInt::parseThreshold;
+
+		BigInt::parseThreshold = 10;
+		resetCounters();
+		BigInt parsed(string(200, '7'));
+		BigInt::parseThreshold = parse;
+
+		for (auto& counter : snapshotCounters())
+			if (counter.name == "multiply" && (counter.calls == 0 || counter.nanoseconds != 0))
+			{
+				cout << "multiplications inside a parse were timed on their own" << endl;
+				success = false;
+			}
+	}
+#endif
+
+	resetCounters();
+	for (auto& counter : snapshotCounters())
+		if (counter.calls != 0 || counter.limbs != 0 || counter.allocations != 0 || counter.nanoseconds != 0)
+		{
+			cout << counter.name << " was not reset" << endl;
+			success = false;
+		}
+
+	if (success)
+		cout << counters.size() << " counters checked" << endl;
+
+	return success;
+}
+
+bool test_stream()
+{
+	bool success = true;
+
+	vector<uint64_t> values { 0, 1, 255, 4294967295ull, 4294967296ull, 1289371928311231231ull, 18446744073709551615ull };
+
+	cout << "test_stream:" << endl;
+	for (auto value : values)
+	{
+		BigInt big(to_string(value));
+
+		vector<function<void(ostream&)>> formats {
+			[](ostream&) {},
+			[](ostream& out) { out << hex; },
+			[](ostream& out) { out << hex << showbase << uppercase; },
+			[](ostream& out) { out << oct << showbase; },
+			[](ostream& out) { out << setw(25) << setfill('*'); },
+			[](ostream& out) { out << left << setw(25) << setfill('.'); },
+			[](ostream& out) { out << internal << hex << showbase << setw(20) << setfill('0'); }
+		};
+
+		for (size_t i = 0; i < formats.size(); i++)
+		{
+			ostringstream expected, actual;
+
+			formats[i](expected);
+			formats[i](actual);
+			expected << value << "|";
+			actual << big << "|";
+
+			if (expected.str() != actual.str())
+			{
+				cout << "format " << i << " of " << value << ": expected " << expected.str()
+				     << ", got " << actual.str() << endl;
+				success = false;
+			}
+		}
+	}
+
+	struct Test
+	{
+		string input;
+		ios_base::fmtflags base;
+		vector<string> values;
+	};
+
+	vector<Test> tests
+	{
+		{"  123 -456\n+789", ios_base::dec, {"123", "-456", "789"}},
+		{"-1561749840894125169814814058904901914569840569840894089415146908974098", ios_base::dec,
+		 {"-1561749840894125169814814058904901914569840569840894089415146908974098"}},
+		{"ff 0x100000000 -DEADBEEFdeadbeef", ios_base::hex, {"255", "4294967296", "-16045690984833335023"}},
+		/* Octal digits straddle words; the 9 is left unread. */
+		{"17 017 -7777777777777777777777 19", ios_base::oct, {"15", "15", "-73786976294838206463", "1"}}
+	};
+
+	for (auto test : tests)
+	{
+		istringstream in(test.input);
+		in.setf(test.base, ios_base::basefield);
+
+		for (auto expected : test.values)
+		{
+			BigInt value;
+			in >> value;
+
+			if (!in || value != BigInt(expected))
+			{
+				cout << "reading \"" << test.input << "\" gave " << (string)value << ", expected " << expected << endl;
+				success = false;
+			}
+		}
+	}
+
+	BigInt untouched(7);
+	istringstream bad("x12");
+	bad >> untouched;
+	if (!bad.fail() || untouched != 7)
+	{
+		cout << "reading \"x12\" did not fail" << endl;
+		success = false;
+	}
+
+	ostringstream signs;
+	signs << showpos << BigInt(5) << " " << BigInt(0) << " " << BigInt("-15") << " "
+	      << hex << showbase << BigInt("-255");
+	if (signs.str() != "+5 +0 -15 -0xff")
+	{
+		cout << "signs were formatted as " << signs.str() << endl;
+		success = false;
+	}
+
+	BigInt big("-" + string(2000, '7'));
+	ostringstream roundtrip;
+	roundtrip << big;
+	if (roundtrip.str() != (string)big)
+	{
+		cout << "streaming a 2000 digit value differs from operator std::string" << endl;
+		success = false;
+	}
+
+	if (success)
+		cout << values.size() << " values formatted and " << tests.size() << " inputs read" << endl;
+
+	return success;
+}
+
+bool test_mapped()
+{
+	bool success = true;
+	const string path("test_mapped.bigint");
+
+	vector<string> values {
+		"0",
+		"4294967296",
+		"-18446744073709551615",
+		"1561749840894125169814814058904901914569840569840894089415146908974098"
+	};
+
+	cout << "test_mapped:" << endl;
+	for (auto value : values)
+	{
+		BigInt original(value);
+		original.save(path);
+
+		MappedBigInt mapped(BigInt::mapFile(path));
+		BigInt copy(mapped);
+
+		if (copy == original && mapped.isNegative() == original.isNegative()
+		    && mapped.size() == original.size() && mapped.isZero() == original.isZero())
+			cout << value << " survives save and mapFile" << endl;
+		else
+		{
+			cout << value << " mapped back as " << (string)copy << endl;
+			success = false;
+		}
+	}
+
+	/* A BigInt made from a mapping reads the file in place, outlives the
+	 * MappedBigInt, and copies the words only when it is written to.
+	 */
+	{
+		const BigInt original(values.back());
+		BigInt view, other;
+
+		original.save(path);
+		{
+			MappedBigInt mapped(BigInt::mapFile(path));
+			view = mapped;
+			other = mapped;
+		}
+		remove(path.c_str());
+
+		if (view.capacity() != 0 || view * view != original * original || -view % 97 != -original % 97)
+		{
+			cout << "a mapped value did not read in place" << endl;
+			success = false;
+		}
+
+		view += 1;
+
+		if (view != original + 1 || other != original || other.capacity() != 0)
+		{
+			cout << "writing to a mapped value changed the file's words" << endl;
+			success = false;
+		}
+	}
+
+	/* Saving over the file a value is mapped from, even from that value, must
+	 * leave the mapping readable and the file whole.
+	 */
+	{
+		const BigInt original(values.back());
+
+		original.save(path);
+
+		BigInt view(BigInt::mapFile(path));
+		view.save(path);
+
+		BigInt reread(BigInt::mapFile(path));
+		(view * view).save(path);
+
+		if (view != original || reread != original || BigInt(BigInt::mapFile(path)) != original * original)
+		{
+			cout << "saving over a mapped file lost its words" << endl;
+			success = false;
+		}
+	}
+
+	/* Saving over a file keeps its permissions; a new file gets the umask's. */
+	{
+		struct stat status;
+
+		chmod(path.c_str(), 0600);
+		BigInt(values.back()).save(path);
+
+		if (stat(path.c_str(), &status) != 0 || (status.st_mode & 0777) != 0600)
+		{
+			cout << "saving over a file changed its permissions" << endl;
+			success = false;
+		}
+
+		remove(path.c_str());
+		mode_t mask = umask(027);
+		BigInt(values.back()).save(path);
+		umask(mask);
+
+		if (stat(path.c_str(), &status) != 0 || (status.st_mode & 0777) != 0640)
+		{
+			cout << "a new file ignored the umask" << endl;
+			success = false;
+		}
+	}
+
+	{
+		ofstream garbage(path, ios::binary);
+		garbage << "definitely not a BigInt file";
+	}
+
+	bool threw = false;
+	try
+	{
+		BigInt::mapFile(path);
+	}
+	catch (const invalid_argument&)
+	{
+		threw = true;
+	}
+
+	if (!threw)
+	{
+		cout << "mapping a corrupt file did not throw" << endl;
+		success = false;
+	}
+
+	remove(path.c_str());
+
+	return success;
+}
+
+bool test_bitwise()
+{
+	bool success = true;
+	size_t checked = 0;
+
+	cout << "test_bitwise:" << endl;
+
+	/* Small values must agree with the machine's own two's complement. */
+	for (int64_t a = -70; a <= 70; a += 7)
+		for (int64_t b = -70; b <= 70; b += 3)
+		{
+			BigInt x(to_string(a)), y(to_string(b));
+
+			if (string(x & y) != to_string(a & b) || string(x | y) != to_string(a | b)
+			    || string(x ^ y) != to_string(a ^ b) || string(~x) != to_string(~a))
+			{
+				cout << a << " and " << b << " disagree" << endl;
+				success = false;
+			}
+
+			checked++;
+		}
+
+	for (int64_t a = -300; a <= 300; a += 37)
+		for (size_t bit = 0; bit < 40; bit++)
+		{
+			BigInt x(to_string(a)), set(x), cleared(x);
+			set.setBit(bit);
+			cleared.setBit(bit, false);
+
+			if (x.testBit(bit) != ((a >> bit & 1) != 0)
+			    || string(set) != to_string(a | int64_t(1) << bit)
+			    || string(cleared) != to_string(a & ~(int64_t(1) << bit)))
+			{
+				cout << "bit " << bit << " of " << a << " is wrong" << endl;
+				success = false;
+			}
+		}
+
+	/* Large values are checked against identities that hold in any two's
+	 * complement.
+	 */
+	BigInt big(factorial(200) + BigInt(12345)), other(primorial(500));
+	vector<pair<BigInt, BigInt>> tests { { big, other }, { -big, other }, { big, -other }, { -big, -other },
+		{ big, BigInt(0) }, { -(BigInt(1) << 96), -(BigInt(1) << 64) } };
+
+	for (auto test : tests)
+	{
+		BigInt& a = test.first;
+		BigInt& b = test.second;
+
+		if ((a & b) + (a | b) != a + b || (a ^ b) != (a | b) - (a & b) || (a ^ b ^ b) != a
+		    || ~~a != a || (a & ~a) != BigInt(0))
+		{
+			cout << (string)a << " and " << (string)b << " break an identity" << endl;
+			success = false;
+		}
+	}
+
+	BigInt sparse((BigInt(1) << 200) + (BigInt(1) << 100) + BigInt(8));
+
+	if (sparse.popcount() != 3 || sparse.countTrailingZeros() != 3 || sparse.size() != 201
+	    || (-sparse).countTrailingZeros() != 3 || BigInt(0).size() != 0)
+	{
+		cout << "popcount, countTrailingZeros or size is wrong" << endl;
+		success = false;
+	}
+
+	if (success)
+		cout << checked << " small pairs and " << tests.size() << " large pairs agree" << endl;
+
+	return success;
+}
+
+bool test_scalars()
+{
+	bool success = true;
+	size_t checked = 0;
+
+	vector<BigInt> values {
+		BigInt(0), BigInt(1), BigInt("-1"), BigInt("4294967295"), BigInt("-4294967296"),
+		BigInt("9223372036854775807"), BigInt("-9223372036854775808"), BigInt("18446744073709551615"),
+		BigInt("18446744073709551616"), -factorial(40), factorial(40)
+	};
+	vector<int64_t> signedScalars { 1, -1, 7, -7, 4294967301, -1099511627776, INT64_MAX, INT64_MIN };
+	vector<uint64_t> unsignedScalars { 1, 10, 4294967296, UINT64_MAX };
+
+	cout << "test_scalars:" << endl;
+
+	/* Signed scalars divide as BigInt does; the unsigned ones are only
+	 * checked against magnitudes, where truncating and flooring agree.
+	 */
+	auto check = [&](const BigInt& x, const BigInt& y, const BigInt& sum, const BigInt& difference,
+		const BigInt& product, const BigInt& quotient, const BigInt& remainder, const vector<bool>& order)
+	{
+		BigInt expectedQuotient(x / y), expectedRemainder(x % y);
+
+		vector<bool> expectedOrder { x == y, x != y, x < y, x > y, x <= y, x >= y };
+
+		if (sum != x + y || difference != x - y || product != x * y || quotient != expectedQuotient
+		    || remainder != expectedRemainder || order != expectedOrder)
+		{
+			cout << (string)x << " and " << (string)y << " disagree" << endl;
+			success = false;
+		}
+
+		checked++;
+	};
+
+	for (auto& x : values)
+	{
+		for (auto scalar : signedScalars)
+		{
+			BigInt compound(x);
+			compound += scalar;
+			compound -= scalar;
+			compound *= scalar;
+			compound /= scalar;
+
+			if (compound != x)
+			{
+				cout << (string)x << " did not survive compound operators with " << scalar << endl;
+				success = false;
+			}
+
+			BigInt remainder(x);
+			remainder %= scalar;
+
+			check(x, BigInt(to_string(scalar)), x + scalar, x - scalar, x * scalar, x / scalar,
+				BigInt(to_string(x % scalar)),
+				{ x == scalar, x != scalar, x < scalar, x > scalar, x <= scalar, x >= scalar });
+			check(x, BigInt(to_string(scalar)), x + scalar, x - scalar, x * scalar, x / scalar, remainder,
+				{ x == scalar, x != scalar, x < scalar, x > scalar, x <= scalar, x >= scalar });
+		}
+
+		for (auto scalar : unsignedScalars)
+		{
+			BigInt magnitude(x.isNegative() ? -x : x);
+
+			check(magnitude, BigInt(to_string(scalar)), magnitude + scalar, magnitude - scalar,
+				magnitude * scalar, magnitude / scalar, BigInt(to_string(magnitude % scalar)),
+				{ magnitude == scalar, magnitude != scalar, magnitude < scalar, magnitude > scalar,
+				  magnitude <= scalar, magnitude >= scalar });
+		}
+
+		BigInt counter(x);
+		counter++;
+		counter += 41;
+		counter--;
+		counter -= 1;
+
+		if (counter != x + BigInt(40) || BigInt(to_string(x % 10)) != x % BigInt(10))
+		{
+			cout << (string)x << " is wrong with int operands" << endl;
+			success = false;
+		}
+	}
+
+	/* long long is not int64_t where that is long, and short and char are
+	 * none of the overloads' own types; all of them must still compile.
+	 */
+	long long wide = -5;
+	unsigned long long unsignedWide = 5;
+	short narrow = -3;
+	BigInt hundred(100), compound(hundred);
+
+	compound += 1LL;
+	compound -= 1ULL;
+	compound *= narrow;
+	compound /= wide;
+	compound %= 7LL;
+
+	if (hundred + wide != 95 || hundred - 3LL != 97 || hundred * unsignedWide != 500ULL || hundred / -3LL != -34
+	    || hundred % -3LL != -2LL || hundred % narrow != -2 || !(hundred == 100LL) || hundred != 100ULL
+	    || !(hundred > wide) || hundred < 5ULL || !(hundred <= 100LL) || !(hundred >= 'a') || compound != 4)
+	{
+		cout << "long long, short and char operands went wrong" << endl;
+		success = false;
+	}
+
+	BigInt seven("-7");
+
+	if (seven / 3 != -3 || seven % 3 != 2 || seven / int64_t(-3) != 2 || seven % int64_t(-3) != -1
+	    || seven / 3u != -2 || seven % 3u != 1 || BigInt(7) / -2 != -4 || BigInt(7) % -2 != -1)
+	{
+		cout << "-7 and 7 divided by small scalars went wrong" << endl;
+		success = false;
+	}
+
+	if (success)
+		cout << checked << " value and scalar pairs agree" << endl;
+
+	return success;
+}
+
+bool test_divexact()
+{
+	bool success = true;
+
+	/* Sizes either side of the threshold take both the word by word and the
+	 * Newton paths.
+	 */
+	vector<BigInt> factors { BigInt(3), BigInt(4096), BigInt("-4294967296"), BigInt("4294967311"),
+		factorial(30), -primorial(400), factorial(300), primorial(2000) * BigInt(1024),
+		factorial(1000) };
+
+	cout << "test_divexact:" << endl;
+	for (size_t i = 0; i < factors.size(); i++)
+		for (size_t j = 0; j < factors.size(); j++)
+		{
+			BigInt& quotient = factors[i];
+			BigInt& divisor = factors[j];
+			BigInt product(quotient * divisor);
+
+			if (product.divexact(divisor) != quotient || !product.divisible(divisor)
+			    || (product + BigInt(1)).divisible(divisor) != (divisor == 1u || divisor == BigInt("-1")))
+			{
+				cout << (string)product << " / " << (string)divisor << " went wrong" << endl;
+				success = false;
+			}
+		}
+
+	for (uint32_t divisor : { 1u, 2u, 3u, 10u, 4294967291u, 2147483648u })
+	{
+		BigInt product(factorial(200) * divisor);
+
+		if (product.divexact(divisor) != factorial(200) || !product.divisible(divisor)
+		    || (divisor > 1 && (product + BigInt(1)).divisible(divisor)) || (-product).divexact(divisor) != -factorial(200))
+		{
+			cout << "dividing by " << divisor << " went wrong" << endl;
+			success = false;
+		}
+	}
+
+	if (!BigInt(0).divisible(BigInt(0)) || BigInt(5).divisible(0u) || BigInt(0).divexact(BigInt(7)) != 0)
+	{
+		cout << "divisibility of or by zero is wrong" << endl;
+		success = false;
+	}
+
+	if (success)
+		cout << factors.size() * factors.size() << " exact quotients are right" << endl;
+
+	return success;
+}
+
+bool test_capacity()
+{
+	bool success = true;
+
+	cout << "test_capacity:" << endl;
+
+	/* Results are sized from their operands, so no more than a word or two
+	 * is ever left spare.
+	 */
+	auto check = [&](const string& what, const BigInt& value)
+	{
+		if (value.capacity() > value.size() + 64)
+		{
+			cout << what << " holds " << value.size() << " bits in " << value.capacity() << endl;
+			success = false;
+		}
+	};
+
+	BigInt a(factorial(2000)), b(primorial(20000));
+
+	check("a product", a * b);
+	check("a sum", a + b);
+	check("a shift", a << 1000);
+	check("a bitwise or", a | b);
+	check("a parsed value", BigInt(string(a)));
+
+	BigInt grown(1);
+	for (size_t i = 0; i < 1000; i++)
+	{
+		grown *= 0xFFFFFFFFu;
+		grown += grown;
+	}
+	check("a value grown in place", grown);
+
+	BigInt reserved(a);
+	reserved.reserve(100000);
+
+	if (reserved.capacity() < 100000 || reserved != a)
+	{
+		cout << "reserve did not make room" << endl;
+		success = false;
+	}
+
+	reserved *= b;
+	reserved.shrink_to_fit();
+
+	if (reserved != a * b || reserved.capacity() != 32 * ((reserved.size() + 31) / 32))
+	{
+		cout << "shrink_to_fit left " << reserved.capacity() << " bits for " << reserved.size() << endl;
+		success = false;
+	}
+
+	if (success)
+		cout << "no result kept more than two spare words" << endl;
+
+	return success;
+}
+
+bool test_shared_words()
+{
+	bool success = true;
+
+	cout << "test_shared_words:" << endl;
+
+	SharedWords words(4, 7), copy(words);
+	const SharedWords& view = copy;
+
+	if (!copy.shared() || view.data() != static_cast<const SharedWords&>(words).data())
+	{
+		cout << "a copy did not share its words" << endl;
+		success = false;
+	}
+
+	copy[0] = 1;
+
+	if (words[0] != 7 || copy[0] != 1 || words.shared() || copy.shared())
+	{
+		cout << "writing a copy did not give it words of its own" << endl;
+		success = false;
+	}
+
+	/* Growing a copy within the spare capacity of a shared block must copy
+	 * it with room for the new words, not just the old ones.
+	 */
+	SharedWords spare(4, 7);
+	spare.reserve(16);
+
+	SharedWords resized(spare), pushed(spare);
+	resized.resize(8, 1);
+	pushed.pop_back();
+	pushed.push_back(2);
+	pushed.push_back(3);
+
+	if (resized.capacity() < resized.size() || pushed.capacity() < pushed.size() || resized[7] != 1
+	    || pushed[3] != 2 || pushed[4] != 3 || spare.size() != 4 || spare[3] != 7)
+	{
+		cout << "growing a shared block did not make room for the new words" << endl;
+		success = false;
+	}
+
+	{
+		const BigInt x(factorial(100));
+		BigInt zero(x - x), grown(zero);
+
+		grown += uint64_t(1) << 40;
+
+		if (grown != BigInt(1) << 40 || !zero.isZero())
+		{
+			cout << "a scalar written into a shared zero went wrong" << endl;
+			success = false;
+		}
+	}
+
+	/* Every way of changing a copy must leave the original alone. */
+	const BigInt original(factorial(2000));
+	const string expected(original);
+
+	vector<pair<string, function<void(BigInt&)>>> mutations {
+		{"+=", [&](BigInt& x) { x += original; }},
+		{"-=", [](BigInt& x) { x -= 12345u; }},
+		{"*=", [](BigInt& x) { x *= 0x9E3779B9u; }},
+		{"/=", [](BigInt& x) { x /= 1000u; }},
+		{"%=", [&](BigInt& x) { x %= original - BigInt(1); }},
+		{"<<=", [](BigInt& x) { x <<= 33; }},
+		{">>=", [](BigInt& x) { x >>= 33; }},
+		{"&=", [](BigInt& x) { x &= BigInt(0xFFFFu); }},
+		{"^=", [&](BigInt& x) { x ^= original; }},
+		{"++", [](BigInt& x) { x++; }},
+		{"negate", [](BigInt& x) { x.negate(); }},
+		{"setBit", [](BigInt& x) { x.setBit(0); }},
+		{"reserve", [](BigInt& x) { x.reserve(1 << 20); x += 1u; }}
+	};
+
+	for (auto& mutation : mutations)
+	{
+		BigInt changed(original);
+		mutation.second(changed);
+
+		if (string(original) != expected || changed == original)
+		{
+			cout << mutation.first << " on a copy changed the original" << endl;
+			success = false;
+		}
+	}
+
+	/* Copies sharing one value may be made, changed and dropped on
+	 * different threads at once.
+	 */
+	vector<thread> threads;
+	vector<int> correct(4, 0);
+
+	for (size_t t = 0; t < correct.size(); t++)
+		threads.emplace_back([&, t]() {
+			BigInt sum;
+
+			for (uint32_t i = 0; i < 200; i++)
+			{
+				BigInt copy(original);
+				copy += i;
+				sum += copy;
+			}
+
+			correct[t] = sum == original * 200u + 199u * 200u / 2;
+		});
+
+	for (auto& thread : threads)
+		thread.join();
+
+	for (size_t t = 0; t < correct.size(); t++)
+		if (!correct[t])
+		{
+			cout << "thread " << t << " summed copies wrongly" << endl;
+			success = false;
+		}
+
+	if (string(original) != expected)
+	{
+		cout << "the threads changed the shared value" << endl;
+		success = false;
+	}
+
+	if (success)
+		cout << "copies shared their words until written" << endl;
+
+	return success;
+}
+
+bool test_accumulator()
+{
+	bool success = true;
+
+	cout << "test_accumulator:" << endl;
+
+	BigIntAccumulator accumulator;
+	BigInt expected;
+
+	if (accumulator.result() != expected)
+	{
+		cout << "an empty accumulator did not hold zero" << endl;
+		success = false;
+	}
+
+	/* Values of mixed signs and sizes, so lanes go negative and the sum
+	 * changes sign along the way.
+	 */
+	BigInt value(factorial(300));
+
+	for (uint32_t i = 0; i < 2000; i++)
+	{
+		BigInt term(value >> (i * 7 % 1500));
+		if (i % 3 == 0)
+			term.negate();
+
+		switch (i % 4)
+		{
+		case 0:
+			accumulator.add(term);
+			expected += term;
+			break;
+		case 1:
+			accumulator.sub(term);
+			expected -= term;
+			break;
+		default:
+			accumulator.addmul(term, 0xFFFFFFFFu - i);
+			expected += term * (0xFFFFFFFFu - i);
+			break;
+		}
+
+		if (i % 250 == 0 && accumulator.result() != expected)
+		{
+			cout << "after " << i + 1 << " terms the sum was " << accumulator.result()
+				<< " instead of " << expected << endl;
+			success = false;
+		}
+	}
+
+	accumulator.sub(expected);
+	accumulator.sub(expected);
+
+	if (accumulator.result() != -expected)
+	{
+		cout << "subtracting twice the sum gave " << accumulator.result() << endl;
+		success = false;
+	}
+
+	if (success)
+		cout << "every sum matched operator+=" << endl;
+
+	return success;
+}
+
+bool test_batch()
+{
+	bool success = true;
+
+	cout << "test_batch:" << endl;
+
+	/* 13 values leaves some of the last vector of lanes as padding. */
+	const size_t count = 13, words = 8;
+	const BigInt modulus((BigInt(1) << 255) - BigInt(19));
+	const BigInt wrap(BigInt(1) << static_cast<uint32_t>(32 * words));
+
+	vector<BigInt> a, b;
+	BigInt seed(factorial(100));
+
+	for (size_t i = 0; i < count; i++)
+	{
+		seed = (seed * 0x9E3779B9u + BigInt(static_cast<uint32_t>(i))) % modulus;
+		a.push_back(seed);
+		b.push_back(i % 4 == 0 ? modulus - BigInt(1) : (seed * seed + BigInt(7)) % modulus);
+	}
+
+	a[0] = BigInt(0);
+
+	const BigIntBatch::Kernel original = BigIntBatch::kernel;
+	const vector<pair<string, BigIntBatch::Kernel>> kernels {
+		{"scalar", BigIntBatch::Kernel::Scalar},
+		{"AVX2", BigIntBatch::Kernel::AVX2},
+		{"AVX-512", BigIntBatch::Kernel::AVX512}
+	};
+
+	for (auto& kernel : kernels)
+	{
+		if (!BigIntBatch::supported(kernel.second))
+		{
+			cout << "skipping the " << kernel.first << " kernel" << endl;
+			continue;
+		}
+
+		BigIntBatch::kernel = kernel.second;
+
+		BigIntBatch x(a, words), y(b, words);
+		BatchMontgomery montgomery(modulus);
+
+		vector<BigInt> sums(x + y), differences(x - y), products(x * y), remainders(montgomery.mulmod(x, y));
+		vector<BigInt> roundtrip(montgomery.fromMontgomery(montgomery.toMontgomery(x)));
+
+		for (size_t i = 0; i < count; i++)
+		{
+			if (sums[i] != (a[i] + b[i]) % wrap || differences[i] != (a[i] - b[i]) % wrap
+				|| products[i] != a[i] * b[i] || remainders[i] != a[i] * b[i] % modulus || roundtrip[i] != a[i])
+			{
+				cout << "the " << kernel.first << " kernel got lane " << i << " wrong" << endl;
+				success = false;
+			}
+		}
+	}
+
+	BigIntBatch::kernel = original;
+
+	try
+	{
+		BigIntBatch batch(vector<BigInt> { wrap }, words);
+
+		cout << "a value wider than the batch was accepted" << endl;
+		success = false;
+	}
+	catch (const invalid_argument&)
+	{
+	}
+
+	if (success)
+		cout << "every supported kernel matched BigInt" << endl;
+
+	return success;
+}
+
+bool test_rns()
+{
+	bool success = true;
+
+	cout << "test_rns:" << endl;
+
+	/* Enough room for the product of two 1000 bit values plus a little. */
+	RNSBasis basis(2010);
+	BigInt a(factorial(150)), b(-(BigInt(3) << 900) + BigInt(12345)), c(primorial(500));
+
+	if (basis.product().size() <= 2011)
+	{
+		cout << "the basis only holds " << basis.product().size() << " bits" << endl;
+		success = false;
+	}
+
+	vector<BigInt> values { BigInt(0), BigInt(1), -BigInt(1), a, -a, b, c };
+
+	for (auto& value : values)
+	{
+		RNSInt x(value, basis);
+
+		if (BigInt(x) != value)
+		{
+			cout << value << " came back as " << BigInt(x) << endl;
+			success = false;
+		}
+
+		for (size_t i = 0; i < basis.size(); i += 7)
+			if (BigInt(x.residue(i)) != value % BigInt(basis.moduli()[i]))
+			{
+				cout << "residue " << i << " of " << value << " was " << x.residue(i) << endl;
+				success = false;
+			}
+	}
+
+	RNSInt x(a, basis), y(b, basis), z(c, basis);
+	BigInt expected(a * b - c * c + a - b);
+
+	if (BigInt(x * y - z * z + x - y) != expected || BigInt(-(x * y)) != -(a * b))
+	{
+		cout << "a chain of operations came back as " << BigInt(x * y - z * z + x - y) << endl;
+		success = false;
+	}
+
+	try
+	{
+		RNSInt wide(BigInt(1) << 2010, basis);
+
+		cout << "a value wider than the basis was accepted" << endl;
+		success = false;
+	}
+	catch (const invalid_argument&)
+	{
+	}
+
+	if (success)
+		cout << "residues matched BigInt in " << basis.size() << " channels" << endl;
+
+	return success;
+}
+
+bool test_bigfloat()
+{
+	bool success = true;
+
+	cout << "test_bigfloat:" << endl;
+
+	/* At 53 bits with ties to even, every operation must round exactly as
+	 * double arithmetic does, including near cancellation.
+	 */
+	vector<double> values;
+	for (int i = 1; i < 40; i++)
+	{
+		values.push_back(std::ldexp(1.0 / (3 * i + 2) - 0.25, 7 * i % 61 - 30));
+		values.push_back(-std::sqrt(static_cast<double>(i)) * 1e9);
+	}
+
+	for (size_t i = 0; i < values.size(); i++)
+		for (size_t j = 0; j < values.size(); j += 7)
+		{
+			double a = values[i], b = i % 5 == 0 ? values[i] * (1 + 1e-13) : values[j];
+			BigFloat x(a, 53), y(b, 53);
+
+			if (x + y != BigFloat(a + b, 53) || x - y != BigFloat(a - b, 53) || x * y != BigFloat(a * b, 53)
+				|| x / y != BigFloat(a / b, 53) || (x < y) != (a < b))
+			{
+				cout << "arithmetic on " << a << " and " << b << " differed from double" << endl;
+				success = false;
+			}
+
+			if (sqrt(BigFloat(std::fabs(a), 53)) != BigFloat(std::sqrt(std::fabs(a)), 53))
+			{
+				cout << "the square root of " << std::fabs(a) << " differed from double" << endl;
+				success = false;
+			}
+		}
+
+	BigFloat tenth("0.1", 53);
+	if (tenth != BigFloat(0.1, 53) || tenth.mantissa() != BigInt("3602879701896397") || tenth.exponent() != -55)
+	{
+		cout << "0.1 was read as " << tenth.mantissa() << " * 2^" << tenth.exponent() << endl;
+		success = false;
+	}
+
+	/* Thousands of digits, checked by squaring at a higher precision. */
+	BigFloat root(sqrt(BigFloat(BigInt(2), 10000))), square(root, 20002);
+	square *= square;
+	BigFloat error(square - BigFloat(BigInt(2))), bound(BigFloat(BigInt(3)) / BigFloat(BigInt(1) << 9999u));
+
+	if (root.toScientific(40) != "1.414213562373095048801688724209698078570e+00"
+		|| (error.isNegative() ? -error : error) > bound)
+	{
+		cout << "sqrt(2) came out as " << root.toScientific(40) << endl;
+		success = false;
+	}
+
+	BigFloat third(BigFloat(BigInt(1), 200) / BigFloat(BigInt(3), 200));
+	if (string(third).substr(0, 12) != "0.3333333333" || BigFloat(string(third), 200) != third)
+	{
+		cout << "1/3 was written as " << string(third) << endl;
+		success = false;
+	}
+
+	vector<pair<BigFloat::Rounding, uint32_t>> modes {
+		{BigFloat::Rounding::ToNearest, 11}, {BigFloat::Rounding::TowardZero, 5},
+		{BigFloat::Rounding::TowardNegative, 11}, {BigFloat::Rounding::TowardPositive, 5}
+	};
+
+	/* -1/3 is -0.0101 0101... in binary: to four bits, 1010 with more than
+	 * half a unit after it.
+	 */
+	for (auto& mode : modes)
+	{
+		BigFloat::rounding = mode.first;
+		BigFloat quotient(BigFloat(-BigInt(1), 4) / BigFloat(BigInt(3), 4));
+
+		if (quotient.mantissa() != -BigInt(mode.second))
+		{
+			cout << "rounding mode " << static_cast<int>(mode.first) << " gave " << quotient.mantissa() << endl;
+			success = false;
+		}
+	}
+
+	BigFloat::rounding = BigFloat::Rounding::ToNearest;
+
+	ostringstream out;
+	out << BigFloat(-1234.5, 53) << " " << fixed << setprecision(3) << BigFloat(2.0 / 3, 53) << " "
+		<< scientific << BigFloat(1e-7, 53);
+
+	istringstream in(" 6.25e-2x");
+	BigFloat read;
+	in >> read;
+
+	if (out.str() != "-1234.5 0.667 1.000e-07" || read != BigFloat(0.0625, 53) || in.get() != 'x')
+	{
+		cout << "stream output was \"" << out.str() << "\" and input read " << read << endl;
+		success = false;
+	}
+
+	/* Exponents far out of range are refused rather than computed. */
+	for (const string text : { "1e1000000000000", "1e-99999999999", "-3.5e99999999999999999999" })
+	{
+		try
+		{
+			BigFloat huge(text);
+
+			cout << text << " was read as " << huge << endl;
+			success = false;
+		}
+		catch (const overflow_error&)
+		{
+		}
+	}
+
+	istringstream tooLarge("1e-99999999999");
+	tooLarge >> read;
+
+	if (!tooLarge.fail() || BigFloat("0e99999999999") != BigFloat())
+	{
+		cout << "out of range exponents were not handled" << endl;
+		success = false;
+	}
+
+	try
+	{
+		sqrt(BigFloat(-2.0));
+
+		cout << "the square root of a negative number was taken" << endl;
+		success = false;
+	}
+	catch (const invalid_argument&)
+	{
+	}
+
+	if (success)
+		cout << "results matched double and sqrt(2) held to 10000 bits" << endl;
+
+	return success;
+}
+
+bool test_gcd()
+{
+	bool success = true;
+
+	cout << "test_gcd:" << endl;
+
+	/* Euclid's algorithm with plain remainders as the reference. */
+	auto euclid = [](BigInt a, BigInt b) {
+		a = a.isNegative() ? -a : a;
+		b = b.isNegative() ? -b : b;
+
+		while (!b.isZero())
+		{
+			BigInt r(a % b);
+			a = std::move(b);
+			b = std::move(r);
+		}
+
+		return a;
+	};
+
+	BigInt f(factorial(700)), p(primorial(3000));
+
+	for (uint32_t i = 1; i < 120; i++)
+	{
+		/* A large common factor, operands far apart in size, and signs. */
+		BigInt common((f >> (i * 7)) + 1u);
+		BigInt a(common * (p >> i)), b(common * ((f >> (2 * i)) + 1u));
+		BigInt c((f >> (i * 3)) * (i * 7919 + 1)), d(i % 3 == 0 ? -(p >> (i * 25)) : p >> (i * 5));
+
+		if (gcd(a, b) != euclid(a, b) || gcd(c, d) != euclid(c, d) || gcd(d, c) != euclid(c, d))
+		{
+			cout << "gcd differed from Euclid's algorithm for i = " << i << endl;
+			success = false;
+		}
+	}
+
+	if (gcd(BigInt(0), BigInt(0)) != 0 || gcd(-BigInt(12), BigInt(0)) != 12 || gcd(-BigInt(12), BigInt(18)) != 6)
+	{
+		cout << "gcd was wrong on small values" << endl;
+		success = false;
+	}
+
+	if (success)
+		cout << "gcd matched Euclid's algorithm" << endl;
+
+	return success;
+}
+
+bool test_rational()
+{
+	bool success = true;
+
+	cout << "test_rational:" << endl;
+
+	const BigRational::Normalization policy = BigRational::normalization;
+	vector<BigRational> results;
+
+	for (auto mode : { BigRational::Normalization::Eager, BigRational::Normalization::Lazy })
+	{
+		BigRational::normalization = mode;
+
+		/* The harmonic sum keeps changing denominators, and the product
+		 * telescopes to n + 1 through ever larger unreduced fractions.
+		 */
+		BigRational harmonic, telescope(BigInt(1)), mixed;
+
+		for (uint32_t i = 1; i <= 300; i++)
+		{
+			harmonic += BigRational(BigInt(1), BigInt(i));
+			telescope *= BigRational(BigInt(i + 1), BigInt(i));
+			mixed = mixed * BigRational(BigInt(3), BigInt(7)) - BigRational(-BigInt(i), BigInt(2 * i + 2))
+				/ BigRational(BigInt(5), BigInt(i + 1));
+		}
+
+		const bool eager = mode == BigRational::Normalization::Eager;
+
+		if (telescope != BigRational(BigInt(301)) || string(telescope) != "301" || (eager && !harmonic.isNormalized()))
+		{
+			cout << "the product came to " << telescope << endl;
+			success = false;
+		}
+
+		if (gcd(harmonic.numerator(), harmonic.denominator()) != 1 || harmonic.floor() != 6
+			|| mixed - mixed != BigRational() || mixed / mixed != BigRational(BigInt(1)))
+		{
+			cout << "the harmonic sum came to " << harmonic << endl;
+			success = false;
+		}
+
+		results.push_back(harmonic);
+		results.push_back(mixed);
+	}
+
+	/* The policies differ only in representation. */
+	if (results[0] != results[2] || results[1] != results[3] || string(results[1]) != string(results[3]))
+	{
+		cout << "the policies disagreed: " << results[1] << " and " << results[3] << endl;
+		success = false;
+	}
+
+	BigRational::normalization = policy;
+
+	if (BigRational("-6/4") != BigRational("3/-2") || string(BigRational("-6/4")) != "-3/2"
+		|| BigRational("-3/4").floor() != -1 || string(BigRational("0/-5")) != "0")
+	{
+		cout << "-6/4 was read as " << BigRational("-6/4") << endl;
+		success = false;
+	}
+
+	try
+	{
+		BigRational(BigInt(1)) / BigRational();
+
+		cout << "division by zero was allowed" << endl;
+		success = false;
+	}
+	catch (const invalid_argument&)
+	{
+	}
+
+	if (success)
+		cout << "both normalization policies gave the same values" << endl;
+
+	return success;
+}
+
+bool test_series()
+{
+	bool success = true;
+
+	cout << "test_series:" << endl;
+
+	/* e = sum of 1 / n!. */
+	Series e;
+	e.p = [](uint64_t) { return BigInt(1); };
+	e.q = [](uint64_t n) { return BigInt(n == 0 ? 1 : static_cast<uint32_t>(n)); };
+	e.a = [](uint64_t) { return BigInt(1); };
+
+	string digits(sumSeries(e, 60, 300).toScientific(50));
+
+	if (digits != "2.7182818284590452353602874713526624977572470937000e+00")
+	{
+		cout << "e came out as " << digits << endl;
+		success = false;
+	}
+
+	/* Chudnovsky: pi = 426880 sqrt(10005) Q / T, about 14 digits a term. */
+	Series pi;
+	pi.p = [](uint64_t n) {
+		if (n == 0)
+			return BigInt(1);
+
+		BigInt term(-BigInt(static_cast<uint32_t>(6 * n - 5)));
+		term *= static_cast<uint32_t>(2 * n - 1);
+		term *= static_cast<uint32_t>(6 * n - 1);
+		return term;
+	};
+	pi.q = [](uint64_t n) {
+		BigInt cube(BigInt(static_cast<uint32_t>(n)) * static_cast<uint32_t>(n) * static_cast<uint32_t>(n));
+		return n == 0 ? BigInt(1) : cube * uint64_t(10939058860032000);
+	};
+	pi.a = [](uint64_t n) { return BigInt(13591409) + uint64_t(545140134) * n; };
+
+	/* Splitting must not depend on the threads or on where nodes live. */
+	SplitOptions serial, parallel, spilled;
+	serial.threads = 1;
+	parallel.threads = 4;
+	spilled.spillDirectory = ".";
+	spilled.spillWords = 64;
+
+	SeriesSplit expected(splitSeries(pi, 0, 300, serial, true));
+
+	for (const SplitOptions* options : { &parallel, &spilled })
+	{
+		SeriesSplit split(splitSeries(pi, 0, 300, *options, true));
+
+		if (split.P != expected.P || split.Q != expected.Q || split.T != expected.T)
+		{
+			cout << "splitting with " << options->threads << " threads and spill directory \""
+				<< options->spillDirectory << "\" gave a different result" << endl;
+			success = false;
+		}
+	}
+
+	SeriesSplit first(splitSeries(pi, 0, 4, serial, true));
+	const size_t precision = 200;
+	BigFloat value(BigFloat(BigInt(426880), precision) * sqrt(BigFloat(BigInt(10005), precision))
+		* BigFloat(first.Q, precision) / BigFloat(first.T, precision));
+
+	digits = value.toScientific(50);
+
+	if (digits != "3.1415926535897932384626433832795028841971693993751e+00")
+	{
+		cout << "pi came out as " << digits << endl;
+		success = false;
+	}
+
+	if (success)
+		cout << "e and pi were right, and every way of splitting agreed" << endl;
+
+	return success;
+}
+
+bool test_powmod()
+{
+	bool success = true;
+
+	cout << "test_powmod:" << endl;
+
+	/* Square and multiply with plain remainders as the reference. */
+	auto reference = [](const BigInt& base, const BigInt& exponent, const BigInt& modulus) {
+		BigInt result(1), power(base % modulus);
+
+		for (size_t bit = 0; bit < exponent.size(); bit++)
+		{
+			if (exponent.testBit(bit))
+				result = result * power % modulus;
+
+			power = power * power % modulus;
+		}
+
+		return result % modulus;
+	};
+
+	BigInt f(factorial(300)), p(primorial(2000));
+	const BigInt moduli[] = { BigInt(3), BigInt(0xFFFFFFFBu), (p >> 2400) | 1u, (f >> 1700) | 1u,
+		(BigInt(1) << 127) - 1u };
+
+	for (const BigInt& modulus : moduli)
+	{
+		ModularContext context(modulus);
+
+		for (uint32_t i = 0; i < 12; i++)
+		{
+			BigInt base(i % 4 == 3 ? -(f >> (i * 40)) : p >> (i * 90));
+			BigInt exponent(i == 0 ? BigInt(0) : (f >> (1550 + i * 40)) + i);
+
+			if (context.powmod(base, exponent) != reference(base, exponent, modulus)
+				|| context.mulmod(base, exponent) != base * exponent % modulus)
+			{
+				cout << "powmod or mulmod differed from the reference for modulus " << modulus
+					<< " and i = " << i << endl;
+				success = false;
+			}
+		}
+	}
+
+	/* Few bases take Straus's method and many Pippenger's. */
+	const BigInt& modulus = moduli[2];
+	ModularContext context(modulus);
+
+	for (size_t count : { 3, 400 })
+	{
+		vector<BigInt> bases, exponents;
+		BigInt expected(1);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			bases.push_back((p >> (i % 97 * 20)) + i);
+			exponents.push_back(i % 10 == 5 ? BigInt(0) : (f >> (1980 + i % 13 * 3)) * (i + 1));
+			expected = expected * reference(bases.back(), exponents.back(), modulus) % modulus;
+		}
+
+		if (context.multiPowmod(bases, exponents) != expected || multiPowmod(bases, exponents, modulus) != expected)
+		{
+			cout << "multiPowmod of " << count << " bases differed from the product of powers" << endl;
+			success = false;
+		}
+	}
+
+	/* Exponents up to the comb's width, and a wider one past it. */
+	BigInt generator(p >> 1000);
+	FixedBasePowmod fixed(context, generator, 300);
+
+	for (uint32_t i = 0; i < 20; i++)
+	{
+		BigInt exponent(i == 19 ? f >> 1500 : (f >> (1745 + i * 15)) + i);
+
+		if (fixed.pow(exponent) != reference(generator, exponent, modulus))
+		{
+			cout << "FixedBasePowmod differed from the reference for a " << exponent.size() << "-bit exponent" << endl;
+			success = false;
+		}
+	}
+
+	for (const BigInt& bad : { BigInt(0), BigInt(1), BigInt(1000) })
+	{
+		try
+		{
+			ModularContext unusable(bad);
+			cout << "a modulus of " << bad << " was accepted" << endl;
+			success = false;
+		}
+		catch (const invalid_argument&)
+		{
+		}
+	}
+
+	try
+	{
+		context.powmod(BigInt(2), -BigInt(1));
+		cout << "a negative exponent was accepted" << endl;
+		success = false;
+	}
+	catch (const invalid_argument&)
+	{
+	}
+
+	if (success)
+		cout << "powmod, multiPowmod and FixedBasePowmod matched square and multiply" << endl;
+
+	return success;
+}
+
+bool test_crt()
+{
+	bool success = true;
+
+	cout << "test_crt:" << endl;
+
+	BigInt f(factorial(2000));
+	const vector<uint32_t> small = { 1, 2, 3, 7, 1000, 65521, 0x7FFFFFFFu, 0xFFFFFFFFu };
+
+	for (uint32_t i = 0; i < 40; i++)
+	{
+		BigInt x(i == 0 ? BigInt(0) : (f >> (i * 500)) + i);
+
+		if (i % 3 == 1)
+			x.negate();
+
+		vector<uint32_t> remainders(residues(x, small));
+
+		for (size_t j = 0; j < small.size(); j++)
+			if (BigInt(remainders[j]) != x % BigInt(small[j]))
+			{
+				cout << "residues gave " << remainders[j] << " for " << x.size() << "-bit x mod "
+					<< small[j] << endl;
+				success = false;
+			}
+	}
+
+	/* Garner's algorithm for a few moduli, even ones included, and the
+	 * product tree for many.
+	 */
+	vector<uint32_t> few = { 1u << 31, 3, 25, 0xFFFFFFFBu, 49, 11 * 13 };
+	vector<uint32_t> many(RNSBasis(60000).moduli());
+
+	for (const vector<uint32_t>* moduli : { &few, &many })
+	{
+		CRTContext context(*moduli);
+		const BigInt& product = context.product();
+
+		for (uint32_t i = 1; i < 10; i++)
+		{
+			BigInt x((f * i + (f >> (i * 7))) % product);
+			BigInt negated(-x);
+
+			if (context.reduce(x) != residues(x, *moduli) || context.combine(context.reduce(x)) != x
+				|| context.combine(context.reduce(negated)) != (negated % product))
+			{
+				cout << "reconstruction from " << moduli->size() << " residues failed for i = " << i << endl;
+				success = false;
+			}
+		}
+	}
+
+	if (crt({ 2, 3, 2 }, { 3, 5, 7 }) != 23 || crt({ 10, 10 }, { 3, 5 }) != 10 || crt({}, {}) != 0)
+	{
+		cout << "crt was wrong on small values" << endl;
+		success = false;
+	}
+
+	many.push_back(many[100]);
+
+	for (const vector<uint32_t>& bad : { vector<uint32_t>{ 6, 9 }, vector<uint32_t>{ 5, 0 }, many })
+	{
+		try
+		{
+			CRTContext unusable(bad);
+			cout << "moduli sharing a factor or with a zero were accepted" << endl;
+			success = false;
+		}
+		catch (const invalid_argument&)
+		{
+		}
+	}
+
+	if (success)
+		cout << "residues matched BigInt %, and crt took them back to the same values" << endl;
+
+	return success;
+}
+
+bool test_out_of_core()
+{
+	bool success = true;
+	const string pathA("test_out_of_core_a.bigint"), pathB("test_out_of_core_b.bigint");
+	const string pathResult("test_out_of_core.bigint"), pathDecimal("test_out_of_core.txt");
+
+	/* A tiny block size pushes even these operands through scratch files
+	 * and many slabs per transform pass.
+	 */
+	size_t blockBytes = diskBlockBytes;
+	diskBlockBytes = 4096;
+
+	BigInt big(factorial(3000)), other(primorial(20000));
+	vector<pair<BigInt, BigInt>> tests {
+		{ big, other },
+		{ -big, other },
+		{ big, -(big + BigInt(1)) },
+		{ other, other },
+		{ BigInt(0), -big },
+		{ BigInt(12345), BigInt(67890) }
+	};
+
+	cout << "test_out_of_core:" << endl;
+	for (auto test : tests)
+	{
+		test.first.save(pathA);
+		test.second.save(pathB);
+
+		MappedBigInt a(BigInt::mapFile(pathA)), b(BigInt::mapFile(pathB));
+		string name = to_string(test.first.size()) + " and " + to_string(test.second.size()) + " bit operands";
+
+		if (BigInt(diskAdd(a, b, pathResult)) != test.first + test.second)
+		{
+			cout << "diskAdd failed for " << name << endl;
+			success = false;
+		}
+
+		if (BigInt(diskSubtract(a, b, pathResult)) != test.first - test.second)
+		{
+			cout << "diskSubtract failed for " << name << endl;
+			success = false;
+		}
+
+		if (BigInt(diskMultiply(a, b, pathResult)) != test.first * test.second)
+		{
+			cout << "diskMultiply failed for " << name << endl;
+			success = false;
+		}
+
+		if (BigInt(diskMultiply(a, a, pathResult)) != test.first * test.first)
+		{
+			cout << "diskMultiply failed to square " << name << endl;
+			success = false;
+		}
+
+		diskToDecimal(a, pathDecimal);
+
+		ifstream file(pathDecimal);
+		string decimal((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+		if (decimal != string(test.first))
+		{
+			cout << "diskToDecimal failed for " << name << endl;
+			success = false;
+		}
+
+		if (BigInt(diskFromDecimal(pathDecimal, pathResult)) != test.first)
+		{
+			cout << "diskFromDecimal failed for " << name << endl;
+			success = false;
+		}
+
+		cout << name << " agree in memory and on disk" << endl;
+	}
+
+	/* Writing over an operand, by any name for its file, must be refused
+	 * before the file is touched.
+	 */
+	{
+		big.save(pathA);
+		other.save(pathB);
+		diskToDecimal(MappedBigInt(BigInt::mapFile(pathA)), pathDecimal);
+
+		MappedBigInt a(BigInt::mapFile(pathA)), b(BigInt::mapFile(pathB));
+		vector<function<void()>> overwrites {
+			[&]() { diskAdd(a, b, pathA); },
+			[&]() { diskSubtract(a, b, "./" + pathB); },
+			[&]() { diskMultiply(a, b, pathB); },
+			[&]() { diskMultiply(b, b, "./" + pathB); },
+			[&]() { diskToDecimal(a, pathA); },
+			[&]() { diskFromDecimal(pathDecimal, "./" + pathDecimal); }
+		};
+
+		for (size_t i = 0; i < overwrites.size(); i++)
+		{
+			try
+			{
+				overwrites[i]();
+				cout << "overwrite " << i << " of an operand was not refused" << endl;
+				success = false;
+			}
+			catch (const invalid_argument&)
+			{
+			}
+		}
+
+		if (BigInt(a) != big || BigInt(b) != other || BigInt(diskFromDecimal(pathDecimal, pathResult)) != big)
+		{
+			cout << "a refused overwrite changed an operand" << endl;
+			success = false;
+		}
+	}
+
+	/* A result still mapped keeps its words when the next one is written to
+	 * the same path, and no temporaries are left behind.
+	 */
+	{
+		MappedBigInt a(BigInt::mapFile(pathA)), b(BigInt::mapFile(pathB));
+		MappedBigInt sum(diskAdd(a, b, pathResult));
+		MappedBigInt product(diskMultiply(a, b, pathResult));
+
+		if (BigInt(sum) != big + other || BigInt(product) != big * other
+		    || BigInt(BigInt::mapFile(pathResult)) != big * other)
+		{
+			cout << "writing a result over a mapped one changed it" << endl;
+			success = false;
+		}
+	}
+
+	diskBlockBytes = blockBytes;
+
+	remove(pathA.c_str());
+	remove(pathB.c_str());
+	remove(pathResult.c_str());
+	remove(pathDecimal.c_str());
+
+	return success;
+}
+
 int main()
 {
 	size_t successes = 0;
@@ -414,7 +2483,34 @@ int main()
 		test_lshift,
 		test_division,
 		test_mod,
-		test_mul
+		test_mul,
+		test_product_tree,
+		test_remainder_tree,
+		test_factorial,
+		test_binomial,
+		test_primorial,
+		test_constant_time,
+		test_fixed_int,
+		test_literal,
+		test_thresholds,
+		test_counters,
+		test_stream,
+		test_mapped,
+		test_out_of_core,
+		test_bitwise,
+		test_scalars,
+		test_divexact,
+		test_capacity,
+		test_shared_words,
+		test_accumulator,
+		test_batch,
+		test_rns,
+		test_bigfloat,
+		test_gcd,
+		test_rational,
+		test_series,
+		test_powmod,
+		test_crt
 	};
 
 	for (auto test : tests)
@@ -0,0 +1,125 @@
+#include <functional>
+#include <future>
+#include <stdexcept>
+
+#include "bigint.hpp"
+#include "tree.hpp"
+
+namespace
+{
+	BigInt product(const std::vector<BigInt>& values, size_t begin, size_t end, unsigned threads)
+	{
+		if (end - begin == 1)
+			return values[begin];
+
+		size_t mid = begin + (end - begin) / 2;
+
+		if (threads > 1 && end - begin >= parallelCutoff)
+		{
+			std::future<BigInt> left = std::async(std::launch::async, product,
+				std::cref(values), begin, mid, threads / 2);
+			BigInt right(product(values, mid, end, threads - threads / 2));
+
+			return left.get() * right;
+		}
+
+		return product(values, begin, mid, 1) * product(values, mid, end, 1);
+	}
+
+	void buildTree(std::vector<BigInt>& tree, size_t node,
+		const std::vector<BigInt>& values, size_t begin, size_t end, unsigned threads)
+	{
+		if (end - begin == 1)
+		{
+			tree[node] = BigInt(values[begin]);
+			return;
+		}
+
+		size_t mid = begin + (end - begin) / 2;
+		size_t left = node + 1, right = rightChild(node, begin, mid);
+
+		if (threads > 1 && end - begin >= parallelCutoff)
+		{
+			std::future<void> pending = std::async(std::launch::async, buildTree,
+				std::ref(tree), left, std::cref(values), begin, mid, threads / 2);
+			buildTree(tree, right, values, mid, end, threads - threads / 2);
+			pending.get();
+		}
+		else
+		{
+			buildTree(tree, left, values, begin, mid, 1);
+			buildTree(tree, right, values, mid, end, 1);
+		}
+
+		tree[node] = tree[left] * tree[right];
+	}
+
+	void descendTree(const std::vector<BigInt>& tree, size_t node, const BigInt& remainder,
+		std::vector<BigInt>& remainders, size_t begin, size_t end, unsigned threads)
+	{
+		if (end - begin == 1)
+		{
+			remainders[begin] = remainder % tree[node];
+			return;
+		}
+
+		size_t mid = begin + (end - begin) / 2;
+		size_t left = node + 1, right = rightChild(node, begin, mid);
+
+		/* Reducing by each child's product first keeps the operands at the
+		 * size of the subtree, which is what makes the descent quasi-linear.
+		 */
+		BigInt leftRemainder(remainder % tree[left]);
+		BigInt rightRemainder(remainder % tree[right]);
+
+		if (threads > 1 && end - begin >= parallelCutoff)
+		{
+			std::future<void> pending = std::async(std::launch::async, descendTree,
+				std::cref(tree), left, std::cref(leftRemainder), std::ref(remainders),
+				begin, mid, threads / 2);
+			descendTree(tree, right, rightRemainder, remainders, mid, end, threads - threads / 2);
+			pending.get();
+		}
+		else
+		{
+			descendTree(tree, left, leftRemainder, remainders, begin, mid, 1);
+			descendTree(tree, right, rightRemainder, remainders, mid, end, 1);
+		}
+	}
+}
+
+BigInt productOf(const std::vector<BigInt>& values)
+{
+	if (values.empty())
+		return BigInt(1);
+
+	return product(values, 0, values.size(), defaultThreads());
+}
+
+std::vector<BigInt> productTree(const std::vector<BigInt>& values)
+{
+	if (values.empty())
+		throw std::invalid_argument("a product tree needs at least one value");
+
+	std::vector<BigInt> tree(2 * values.size() - 1);
+	buildTree(tree, 0, values, 0, values.size(), defaultThreads());
+
+	return tree;
+}
+
+std::vector<BigInt> remaindersOf(const BigInt& x, const std::vector<BigInt>& moduli)
+{
+	std::vector<BigInt> remainders(moduli.size());
+
+	if (moduli.empty())
+		return remainders;
+
+	for (const auto& modulus : moduli)
+		if (modulus.isNegative() || modulus.isZero())
+			throw std::invalid_argument("moduli must be positive");
+
+	std::vector<BigInt> tree(productTree(moduli));
+	descendTree(tree, 0, x % tree[0], remainders, 0, moduli.size(), defaultThreads());
+
+	return remainders;
+}
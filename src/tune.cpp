@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "bigint.hpp"
+
+using namespace std;
+
+/* Usage: tune.exe [output header]
+ *
+ * For each threshold, we time the operation at increasing sizes twice: once
+ * with the threshold just above the size (so the simple algorithm runs at the
+ * top level) and once with it equal to the size (so one level of the fast
+ * algorithm runs on top of the simple one). The threshold is the first size
+ * at which the fast algorithm wins twice in a row.
+ */
+
+namespace
+{
+	const double minSeconds = 0.02;
+	const size_t trials = 3;
+
+	mt19937 generator(42);
+
+	BigInt randomWords(size_t count)
+	{
+		if (count == 1)
+		{
+			uint32_t word = generator();
+			return BigInt(word == 0 ? 1 : word);
+		}
+
+		size_t low = count / 2;
+		BigInt high(randomWords(count - low));
+		high <<= static_cast<uint32_t>(32 * low);
+
+		return high + randomWords(low);
+	}
+
+	string randomDigits(size_t count)
+	{
+		string digits(count, '0');
+
+		for (auto& digit : digits)
+			digit = static_cast<char>('0' + generator() % 10);
+
+		digits[0] = static_cast<char>('1' + generator() % 9);
+
+		return digits;
+	}
+
+	volatile size_t sink;
+
+	/* The fastest of a few trials, in nanoseconds per call. */
+	double time(const function<void()>& run)
+	{
+		double best = 0;
+
+		for (size_t trial = 0; trial < trials; trial++)
+		{
+			size_t iterations = 0;
+			auto start = chrono::steady_clock::now();
+			chrono::duration<double> elapsed;
+
+			do
+			{
+				run();
+				iterations++;
+				elapsed = chrono::steady_clock::now() - start;
+			}
+			while (elapsed.count() < minSeconds);
+
+			double nanoseconds = elapsed.count() * 1e9 / iterations;
+			if (trial == 0 || nanoseconds < best)
+				best = nanoseconds;
+		}
+
+		return best;
+	}
+
+	size_t findCrossover(const string& name, size_t& threshold, const vector<size_t>& sizes,
+		const function<function<void()>(size_t)>& setup)
+	{
+		size_t wins = 0;
+
+		for (size_t i = 0; i < sizes.size(); i++)
+		{
+			size_t size = sizes[i];
+			function<void()> run(setup(size));
+
+			threshold = size + 1;
+			double simple = time(run);
+
+			threshold = size;
+			double fast = time(run);
+
+			cerr << name << " " << size << ": " << simple << " ns simple, " << fast << " ns split" << endl;
+
+			wins = fast < simple ? wins + 1 : 0;
+
+			if (wins == 2)
+				return sizes[i - 1];
+		}
+
+		return sizes.back();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	string path(argc > 1 ? argv[1] : "include/tuned.hpp");
+
+	vector<size_t> wordSizes;
+	for (size_t words = 4; words <= 256; words += words < 32 ? 2 : words / 8)
+		wordSizes.push_back(words);
+
+	size_t karatsuba = findCrossover("karatsuba", BigInt::karatsubaThreshold, wordSizes, [](size_t n) {
+		BigInt a(randomWords(n)), b(randomWords(n));
+		return [=]() { sink = (a * b).size(); };
+	});
+	BigInt::karatsubaThreshold = karatsuba;
+
+	vector<size_t> digitSizes;
+	for (size_t digits = 100; digits <= 40000; digits += digits / 4)
+		digitSizes.push_back(digits);
+
+	size_t parse = findCrossover("parse", BigInt::parseThreshold, digitSizes, [](size_t n) {
+		string decimal(randomDigits(n));
+		return [=]() { sink = BigInt(decimal).size(); };
+	});
+	BigInt::parseThreshold = parse;
+
+	ofstream header(path);
+
+	header << "#ifndef INCLUDE_TUNED_HPP" << endl
+	       << "#define INCLUDE_TUNED_HPP" << endl
+	       << endl
+	       << "/* Generated by `make tune` for the machine it ran on. */" << endl
+	       << endl
+	       << "#define KARATSUBA_THRESHOLD " << karatsuba << endl
+	       << "#define PARSE_THRESHOLD " << parse << endl
+	       << endl
+	       << "#endif" << endl;
+
+	if (!header)
+	{
+		cerr << "could not write " << path << endl;
+		return 1;
+	}
+
+	cout << "wrote " << path << ": KARATSUBA_THRESHOLD " << karatsuba
+	     << ", PARSE_THRESHOLD " << parse << endl;
+
+	return 0;
+}